@@ -6,5 +6,6 @@
 /* #undef HAVE_LIBSAMPLERATE */
 /* #undef HAVE_LIBPNG */
 #define HAVE_DIRENT_H
+#define HAVE_MMAP
 #define HAVE_DECL_STRCASECMP 1
 #define HAVE_DECL_STRNCASECMP 1
@@ -0,0 +1,139 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Headless setup shared by the benchmark programs: loads the
+//	IWAD and starts a level with no video, sound or input.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "../game/game.h"
+#include "../game/gamemode.h"
+#include "../game/loop.h"
+#include "../game/stat.h"
+#include "../hud/stuff.h"
+#include "../impl/system.h"
+#include "../impl/video.h"
+#include "../lib/argv.h"
+#include "../mem/zone.h"
+#include "../menu/menu.h"
+#include "../misc/misc.h"
+#include "../player/local.h"
+#include "../player/setup.h"
+#include "../renderer/local.h"
+#include "../sound/sound.h"
+#include "../status/stuff.h"
+#include "../wad/iwad.h"
+#include "../wad/main.h"
+#include "../wad/wad.h"
+
+#include "bench.h"
+
+void D_IdentifyVersion(void);
+void R_ExecuteSetViewSize(void);
+
+//
+// B_Init
+//
+void B_Init(void) {
+    char *iwadfile;
+
+    M_FindResponseFile();
+
+    Z_Init();
+
+    iwadfile = D_FindIWAD(IWAD_MASK_DOOM, &gamemission);
+
+    if (iwadfile == NULL)
+        error("No IWAD file was found.  Try specifying one with the '-iwad' command line parameter.");
+
+    W_AddFile(iwadfile);
+    W_CheckCorrectIWAD(doom);
+    D_IdentifyVersion();
+    gameversion = exe_doom_1_9;
+
+    modifiedgame = W_ParseCommandLine();
+    W_GenerateHashTable();
+
+    // Full screen view, no status bar.
+    screenblocks = 11;
+    detailLevel = 0;
+
+    // Run without the network loop.
+    singletics = true;
+
+    I_VideoBuffer = Z_Malloc(SCREENWIDTH * SCREENHEIGHT * sizeof(*I_VideoBuffer), PU_STATIC, NULL);
+    memset(I_VideoBuffer, 0, SCREENWIDTH * SCREENHEIGHT * sizeof(*I_VideoBuffer));
+
+    R_Init();
+    P_Init();
+    S_Init(0, 0);
+    HU_Init();
+    ST_Init();
+
+    R_ExecuteSetViewSize();
+}
+
+//
+// B_StartLevel
+//
+void B_StartLevel(void) {
+    int episode;
+    int map;
+    skill_t skill;
+    int p;
+
+    skill = sk_medium;
+    episode = 1;
+    map = 1;
+
+    p = M_CheckParmWithArgs("-skill", 1);
+
+    if (p)
+        skill = myargv[p + 1][0] - '1';
+
+    p = M_CheckParmWithArgs("-warp", 1);
+
+    if (p) {
+        episode = myargv[p + 1][0] - '0';
+
+        if (p + 2 < myargc)
+            map = myargv[p + 2][0] - '0';
+    }
+
+    playeringame[0] = true;
+    consoleplayer = displayplayer = 0;
+
+    G_InitNew(skill, episode, map);
+}
+
+unsigned int B_CRC32(const byte *data, int length) {
+    unsigned int crc = 0xffffffff;
+    int i;
+
+    while (length-- > 0) {
+        crc ^= *data++;
+
+        for (i = 0; i < 8; i++)
+            crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+
+    return ~crc;
+}
+
+double B_Milliseconds(Uint64 ticks) { return ticks * 1000.0 / SDL_GetPerformanceFrequency(); }
@@ -0,0 +1,35 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Headless setup shared by the benchmark programs.
+//
+
+#ifndef __B_BENCH__
+#define __B_BENCH__
+
+#include "SDL.h"
+
+#include "../lib/type.h"
+
+// Starts the engine with no video, sound or input.
+void B_Init(void);
+
+// Starts the level given by -warp and -skill.
+void B_StartLevel(void);
+
+unsigned int B_CRC32(const byte *data, int length);
+double B_Milliseconds(Uint64 ticks);
+
+#endif
@@ -0,0 +1,246 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Headless renderer benchmark.  Loads a level, renders the view
+//	from a list of viewpoints with no video, sound or input, and
+//	prints frame times and a CRC of each viewpoint's frame.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#include "../game/stat.h"
+#include "../impl/system.h"
+#include "../impl/video.h"
+#include "../lib/argv.h"
+#include "../player/local.h"
+#include "../player/setup.h"
+#include "../renderer/local.h"
+
+#include "bench.h"
+
+#define DEFAULTFRAMES 100
+
+typedef struct {
+    fixed_t x;
+    fixed_t y;
+    angle_t angle;
+    int degrees;
+
+    // View height in map units; on the floor if not given.
+    boolean onfloor;
+    fixed_t z;
+} viewpoint_t;
+
+static viewpoint_t *viewpoints;
+static int numviewpoints;
+static int maxviewpoints;
+
+static void AddViewpoint(int x, int y, int degrees, boolean onfloor, int z) {
+    viewpoint_t *vp;
+
+    if (numviewpoints == maxviewpoints) {
+        maxviewpoints = maxviewpoints ? maxviewpoints * 2 : 16;
+        viewpoints = I_Realloc(viewpoints, maxviewpoints * sizeof(*viewpoints));
+    }
+
+    degrees %= 360;
+
+    if (degrees < 0)
+        degrees += 360;
+
+    vp = &viewpoints[numviewpoints++];
+    vp->x = x << FRACBITS;
+    vp->y = y << FRACBITS;
+    vp->angle = (angle_t)(((unsigned long long)degrees << 32) / 360);
+    vp->degrees = degrees;
+    vp->onfloor = onfloor;
+    vp->z = z << FRACBITS;
+}
+
+//
+// LoadViewpoints
+// One viewpoint per line: x y angle [z], in map units and degrees.
+// Blank lines and lines starting with # are skipped.
+//
+static void LoadViewpoints(const char *filename) {
+    char line[256];
+    FILE *file;
+    int x, y, degrees, z;
+    int n;
+
+    file = fopen(filename, "r");
+
+    if (file == NULL)
+        error("LoadViewpoints: couldn't open %s", filename);
+
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (line[0] == '#')
+            continue;
+
+        n = sscanf(line, "%i %i %i %i", &x, &y, &degrees, &z);
+
+        if (n <= 0)
+            continue;
+
+        if (n < 3)
+            error("LoadViewpoints: bad line in %s: %s", filename, line);
+
+        AddViewpoint(x, y, degrees, n < 4, z);
+    }
+
+    fclose(file);
+
+    if (numviewpoints == 0)
+        error("LoadViewpoints: no viewpoints in %s", filename);
+}
+
+//
+// DefaultViewpoints
+// Look around from the player 1 start.
+//
+static void DefaultViewpoints(void) {
+    int i;
+
+    for (i = 0; i < 8; i++)
+        AddViewpoint(playerstarts[0].x, playerstarts[0].y, playerstarts[0].angle + i * 45, true, 0);
+}
+
+//
+// SetViewpoint
+// Moves the console player to a viewpoint.
+//
+static void SetViewpoint(viewpoint_t *vp) {
+    player_t *player = &players[consoleplayer];
+    mobj_t *mo = player->mo;
+
+    P_UnsetThingPosition(mo);
+    mo->x = vp->x;
+    mo->y = vp->y;
+    P_SetThingPosition(mo);
+
+    mo->angle = vp->angle;
+    mo->z = mo->subsector->sector->floorheight;
+
+    if (vp->onfloor)
+        player->viewz = mo->z + VIEWHEIGHT;
+    else
+        player->viewz = vp->z;
+}
+
+//
+// RunBenchmark
+//
+static void RunBenchmark(int frames) {
+    viewpoint_t *vp;
+    player_t *player;
+    Uint64 start, ticks;
+    Uint64 mintime, maxtime, total, alltotal;
+    int i, j;
+
+    player = &players[consoleplayer];
+    alltotal = 0;
+
+    printf("\n  #      x      y  angle     min ms     avg ms     max ms       crc\n");
+
+    for (i = 0; i < numviewpoints; i++) {
+        vp = &viewpoints[i];
+        SetViewpoint(vp);
+
+        // One untimed frame to fault everything in.
+        R_RenderPlayerView(player);
+
+        mintime = (Uint64)-1;
+        maxtime = 0;
+        total = 0;
+
+        for (j = 0; j < frames; j++) {
+            start = SDL_GetPerformanceCounter();
+            R_RenderPlayerView(player);
+            ticks = SDL_GetPerformanceCounter() - start;
+
+            if (ticks < mintime)
+                mintime = ticks;
+            if (ticks > maxtime)
+                maxtime = ticks;
+
+            total += ticks;
+        }
+
+        alltotal += total;
+
+        printf("%3i %6i %6i %6i %10.3f %10.3f %10.3f  %08x\n", i, vp->x >> FRACBITS, vp->y >> FRACBITS,
+               vp->degrees, B_Milliseconds(mintime), B_Milliseconds(total) / frames, B_Milliseconds(maxtime),
+               B_CRC32(I_VideoBuffer, SCREENWIDTH * SCREENHEIGHT));
+    }
+
+    printf("\n%i frames in %.3f ms, %.3f ms per frame\n", numviewpoints * frames, B_Milliseconds(alltotal),
+           B_Milliseconds(alltotal) / (numviewpoints * frames));
+}
+
+int main(int argc, char **argv) {
+    int frames;
+    int p;
+
+    myargc = argc;
+    myargv = argv;
+
+    B_Init();
+
+    //!
+    // @category obscure
+    // @arg <n>
+    //
+    // Renderer benchmark: number of frames timed at each viewpoint.
+    //
+
+    frames = DEFAULTFRAMES;
+    p = M_CheckParmWithArgs("-frames", 1);
+
+    if (p)
+        frames = atoi(myargv[p + 1]);
+
+    if (frames < 1)
+        frames = 1;
+
+    B_StartLevel();
+
+    //!
+    // @category obscure
+    // @arg <file>
+    //
+    // Renderer benchmark: read viewpoints from the given file, one
+    // "x y angle [z]" per line.  The default is to look around from
+    // the player 1 start.
+    //
+
+    p = M_CheckParmWithArgs("-viewpoints", 1);
+
+    if (p)
+        LoadViewpoints(myargv[p + 1]);
+    else
+        DefaultViewpoints();
+
+    printf("E%iM%i, %i viewpoints, %i frames each\n", gameepisode, gamemap, numviewpoints, frames);
+
+    RunBenchmark(frames);
+
+    I_Quit();
+
+    return 0;
+}
@@ -0,0 +1,192 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Headless playsim benchmark.  Loads a level, optionally fills it
+//	with an awake horde of monsters, runs the tickers with no input
+//	and prints the time per tic and a checksum of where every thing
+//	ended up.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#include "../game/stat.h"
+#include "../impl/system.h"
+#include "../lib/argv.h"
+#include "../player/local.h"
+#include "../player/tick.h"
+
+#include "bench.h"
+
+#define DEFAULTTICS 1050
+#define WARMUPTICS 35
+
+//
+// SpawnHorde
+// Drops monsters on free spots across the map, and wakes them up
+//  chasing the player so that they all move and collide every tic.
+//
+static int SpawnHorde(mobjtype_t type, int count) {
+    mobj_t *player;
+    mobj_t *mo;
+    sector_t *sec;
+    unsigned int seed;
+    fixed_t x, y;
+    int attempts;
+    int spawned;
+
+    player = players[consoleplayer].mo;
+    seed = 1;
+    spawned = 0;
+
+    for (attempts = 0; spawned < count && attempts < count * 16; attempts++) {
+        seed = seed * 1103515245 + 12345;
+        x = bmaporgx + (fixed_t)((seed >> 8) % (bmapwidth * MAPBLOCKUNITS)) * FRACUNIT;
+        seed = seed * 1103515245 + 12345;
+        y = bmaporgy + (fixed_t)((seed >> 8) % (bmapheight * MAPBLOCKUNITS)) * FRACUNIT;
+
+        mo = P_SpawnMobj(x, y, ONFLOORZ, type);
+        sec = mo->subsector->sector;
+
+        if (sec->ceilingheight - sec->floorheight < mo->height || !P_CheckPosition(mo, x, y)) {
+            P_RemoveMobj(mo);
+            continue;
+        }
+
+        mo->target = player;
+        P_SetMobjState(mo, mo->info->seestate);
+        spawned++;
+    }
+
+    return spawned;
+}
+
+static unsigned int ThingChecksum(int *count) {
+    thinker_t *th;
+    mobj_t *mo;
+    unsigned int sum;
+
+    sum = 0;
+    *count = 0;
+
+    for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+        if (th->function.acp1 != (actionf_p1)P_MobjThinker)
+            continue;
+
+        mo = (mobj_t *)th;
+        sum = sum * 31 + mo->x;
+        sum = sum * 31 + mo->y;
+        sum = sum * 31 + mo->z;
+        sum = sum * 31 + mo->health;
+        (*count)++;
+    }
+
+    return sum;
+}
+
+//
+// RunBenchmark
+//
+static void RunBenchmark(int tics) {
+    Uint64 start, ticks;
+    Uint64 mintime, maxtime, total;
+    unsigned int sum;
+    int things;
+    int i;
+
+    for (i = 0; i < WARMUPTICS; i++)
+        P_Ticker();
+
+    mintime = (Uint64)-1;
+    maxtime = 0;
+    total = 0;
+
+    for (i = 0; i < tics; i++) {
+        start = SDL_GetPerformanceCounter();
+        P_Ticker();
+        ticks = SDL_GetPerformanceCounter() - start;
+
+        if (ticks < mintime)
+            mintime = ticks;
+        if (ticks > maxtime)
+            maxtime = ticks;
+
+        total += ticks;
+    }
+
+    sum = ThingChecksum(&things);
+
+    printf("%i tics in %.3f ms: min %.3f ms, avg %.3f ms, max %.3f ms\n", tics, B_Milliseconds(total),
+           B_Milliseconds(mintime), B_Milliseconds(total) / tics, B_Milliseconds(maxtime));
+    printf("%i things, checksum %08x\n", things, sum);
+}
+
+int main(int argc, char **argv) {
+    int tics;
+    int horde;
+    int spawned;
+    int p;
+
+    myargc = argc;
+    myargv = argv;
+
+    B_Init();
+
+    //!
+    // @category obscure
+    // @arg <n>
+    //
+    // Playsim benchmark: number of tics to time.
+    //
+
+    tics = DEFAULTTICS;
+    p = M_CheckParmWithArgs("-tics", 1);
+
+    if (p)
+        tics = atoi(myargv[p + 1]);
+
+    if (tics < 1)
+        tics = 1;
+
+    B_StartLevel();
+
+    // Keep the player alive so that the level keeps running.
+    players[consoleplayer].cheats |= CF_GODMODE;
+
+    //!
+    // @category obscure
+    // @arg <n>
+    //
+    // Playsim benchmark: add up to n awake imps to the level.
+    //
+
+    spawned = 0;
+    p = M_CheckParmWithArgs("-horde", 1);
+
+    if (p) {
+        horde = atoi(myargv[p + 1]);
+        spawned = SpawnHorde(MT_TROOP, horde);
+    }
+
+    printf("E%iM%i, %i monsters added, %i tics\n", gameepisode, gamemap, spawned, tics);
+
+    RunBenchmark(tics);
+
+    I_Quit();
+
+    return 0;
+}
@@ -0,0 +1,261 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Zone allocator benchmark.  Replays a synthetic load shaped like
+//	the game's: static data at startup, level data freed with
+//	Z_FreeTags at each level exit, and a lump cache bigger than the
+//	zone being read every frame.  It is built once per allocator.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "SDL.h"
+
+#include "../impl/system.h"
+#include "../lib/argv.h"
+#include "../mem/zone.h"
+
+#include "bench.h"
+
+#define DEFAULTLEVELS 20
+#define FRAMES 2100
+
+#define NUMLUMPS 3000
+#define LUMPSPERFRAME 200
+#define TEMPSPERFRAME 20
+#define LEVELBLOCKS 400
+#define DEFAULTKEEP 64
+
+typedef enum {
+    op_level, // allocate level data
+    op_lump,  // read a lump through the cache
+    op_temp,  // allocate a short lived block
+    op_free,  // free it
+    op_keep,  // or keep it until the level ends
+    op_exit   // free the level
+} opcode_t;
+
+typedef struct {
+    opcode_t op;
+    int arg;
+} op_t;
+
+static op_t *ops;
+static int numops;
+static int maxops;
+
+static void *lumpcache[NUMLUMPS];
+static int lumpsizes[NUMLUMPS];
+
+static unsigned int seed = 1;
+static int keep;
+
+static int Random(int range) {
+    seed = seed * 1103515245 + 12345;
+
+    return (seed >> 8) % range;
+}
+
+//
+// RandomSize
+// Mostly small blocks, with the odd big one.
+//
+static int RandomSize(int small, int big) {
+    if (Random(8) == 0)
+        return 1 + Random(big);
+
+    return 1 + Random(small);
+}
+
+static void AddOp(opcode_t op, int arg) {
+    if (numops == maxops) {
+        maxops = maxops ? maxops * 2 : 1024;
+        ops = I_Realloc(ops, maxops * sizeof(*ops));
+    }
+
+    ops[numops].op = op;
+    ops[numops].arg = arg;
+    numops++;
+}
+
+//
+// MakeLevel
+// Builds the list of zone calls made while playing one level, so
+//  that only the zone calls themselves are timed.
+//
+static void MakeLevel(void) {
+    int i, j;
+
+    numops = 0;
+
+    // Level data: vertexes, lines, sectors, the blockmap and so on.
+    for (i = 0; i < LEVELBLOCKS; i++)
+        AddOp(op_level, RandomSize(1024, 128 * 1024));
+
+    for (i = 0; i < FRAMES; i++) {
+        // Textures, flats, patches and sprites, a few of them often.
+        for (j = 0; j < LUMPSPERFRAME; j++) {
+            if (Random(4) == 0)
+                AddOp(op_lump, Random(NUMLUMPS));
+            else
+                AddOp(op_lump, Random(NUMLUMPS / 10));
+        }
+
+        // Short lived blocks, and the odd one kept for the level.
+        for (j = 0; j < TEMPSPERFRAME; j++)
+            AddOp(op_temp, RandomSize(256, 4096));
+
+        for (j = 0; j < TEMPSPERFRAME; j++)
+            AddOp(Random(keep) == 0 ? op_keep : op_free, j);
+    }
+
+    AddOp(op_exit, 0);
+}
+
+//
+// RunLevel
+// Returns the number of zone calls made.
+//
+static int RunLevel(int *misses) {
+    void *temps[TEMPSPERFRAME];
+    int calls;
+    int temp;
+    op_t *op;
+
+    calls = 0;
+    temp = 0;
+
+    for (op = ops; op < ops + numops; op++) {
+        switch (op->op) {
+        case op_level:
+            Z_Malloc(op->arg, PU_LEVEL, NULL);
+            break;
+
+        case op_lump:
+            // A hit marks the lump as used, as W_CacheLumpNum does.
+            if (lumpcache[op->arg] != NULL) {
+                Z_Touch(lumpcache[op->arg]);
+                break;
+            }
+
+            Z_Malloc(lumpsizes[op->arg], PU_CACHE, &lumpcache[op->arg]);
+            (*misses)++;
+            break;
+
+        case op_temp:
+            temps[temp++ % TEMPSPERFRAME] = Z_Malloc(op->arg, PU_STATIC, NULL);
+            break;
+
+        case op_free:
+            Z_Free(temps[op->arg]);
+            break;
+
+        case op_keep:
+            Z_ChangeTag(temps[op->arg], PU_LEVEL);
+            break;
+
+        case op_exit:
+            Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+            break;
+        }
+
+        calls++;
+    }
+
+    return calls;
+}
+
+int main(int argc, char **argv) {
+    Uint64 start, ticks;
+    Uint64 maxtime, total;
+    int levels;
+    int calls;
+    int misses;
+    int i;
+    int p;
+
+    myargc = argc;
+    myargv = argv;
+
+    //!
+    // @category obscure
+    // @arg <n>
+    //
+    // Zone benchmark: number of levels to play through.
+    //
+
+    levels = DEFAULTLEVELS;
+    p = M_CheckParmWithArgs("-levels", 1);
+
+    if (p)
+        levels = atoi(myargv[p + 1]);
+
+    if (levels < 1)
+        levels = 1;
+
+    //!
+    // @category obscure
+    // @arg <n>
+    //
+    // Zone benchmark: keep one in n short lived blocks until the end
+    // of the level (default 64).  These are what fragment the zone.
+    //
+
+    keep = DEFAULTKEEP;
+    p = M_CheckParmWithArgs("-keep", 1);
+
+    if (p)
+        keep = atoi(myargv[p + 1]);
+
+    if (keep < 1)
+        keep = 1;
+
+    Z_Init();
+
+    for (i = 0; i < NUMLUMPS; i++)
+        lumpsizes[i] = RandomSize(4096, 32 * 1024);
+
+    // Startup: the WAD directory, tables and the screen buffers.
+    for (i = 0; i < 500; i++)
+        Z_Malloc(RandomSize(2048, 64 * 1024), PU_STATIC, NULL);
+
+    calls = 0;
+    misses = 0;
+    maxtime = 0;
+    total = 0;
+
+    for (i = 0; i < levels; i++) {
+        MakeLevel();
+
+        start = SDL_GetPerformanceCounter();
+        calls += RunLevel(&misses);
+        ticks = SDL_GetPerformanceCounter() - start;
+
+        if (ticks > maxtime)
+            maxtime = ticks;
+
+        total += ticks;
+    }
+
+    Z_CheckHeap();
+
+    printf("%i levels, %i zone calls, %i cache misses\n", levels, calls, misses);
+    printf("%.3f ms total, %.3f ms per level (max %.3f), %.1f ns per call\n", B_Milliseconds(total),
+           B_Milliseconds(total) / levels, B_Milliseconds(maxtime),
+           B_Milliseconds(total) * 1000000.0 / calls);
+
+    return 0;
+}
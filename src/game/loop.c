@@ -82,6 +82,15 @@ int gametic;
 
 boolean singletics = false;
 
+// When set to true, TryRunTics() returns without waiting when there is
+// no tic to run, so the view can be drawn again between tics.
+
+boolean uncapped = false;
+
+// When the last tic was run, for D_GetFractionalTic().
+
+static uint64_t lastticus;
+
 // Index of the local player.
 
 static int localplayer;
@@ -636,6 +645,11 @@ void TryRunTics(void) {
     if (counts < 1)
         counts = 1;
 
+    // With an uncapped framerate, draw another frame
+    //  rather than wait for the next tic.
+    if (uncapped && !singletics && PlayersInGame() && lowtic <= gametic / ticdup)
+        return;
+
     // wait for new tics if needed
     while (!PlayersInGame() || lowtic < gametic / ticdup + counts) {
         NetUpdate();
@@ -680,6 +694,7 @@ void TryRunTics(void) {
 
             loop_interface->RunTic(set->cmds, set->ingame);
             gametic++;
+            lastticus = I_GetTimeUS();
 
             // modify command for duplicated tics
 
@@ -692,6 +707,25 @@ void TryRunTics(void) {
 
 void D_RegisterLoopCallbacks(loop_interface_t *i) { loop_interface = i; }
 
+//
+// D_GetFractionalTic
+// How far the clock has got towards the next tic since the last
+//  one was run, from 0 to FRACUNIT.
+//
+fixed_t D_GetFractionalTic(void) {
+    uint64_t elapsed;
+
+    if (!uncapped || singletics)
+        return FRACUNIT;
+
+    elapsed = I_GetTimeUS() - lastticus;
+
+    if (elapsed >= 1000000 / TICRATE)
+        return FRACUNIT;
+
+    return (fixed_t)(elapsed * TICRATE * FRACUNIT / 1000000);
+}
+
 // TODO: Move nonvanilla demo functions into a dedicated file.
 
 static boolean StrictDemos(void) {
@@ -19,6 +19,7 @@
 #ifndef __D_LOOP__
 #define __D_LOOP__
 
+#include "../lib/fixed.h"
 #include "../net/defs.h"
 
 // Callback function invoked while waiting for the netgame to start.
@@ -62,6 +63,9 @@ void TryRunTics(void);
 // Called at start of game loop to initialize timers
 void D_StartGameLoop(void);
 
+// Fraction of the way to the next tic, for drawing between tics.
+fixed_t D_GetFractionalTic(void);
+
 // Initialize networking code and connect to server.
 
 boolean D_InitNetGame(net_connect_data_t *connect_data);
@@ -72,6 +76,7 @@ boolean D_InitNetGame(net_connect_data_t *connect_data);
 void D_StartNetGame(net_gamesettings_t *settings, netgame_startup_callback_t callback);
 
 extern boolean singletics;
+extern boolean uncapped;
 extern int gametic, ticdup;
 
 // Check if it is permitted to record a demo with a non-vanilla feature.
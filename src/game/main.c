@@ -391,7 +391,10 @@ void D_RunFrame() {
     // frame syncronous IO operations
     I_StartFrame();
 
-    TryRunTics(); // will run at least one tic
+    TryRunTics(); // will run at least one tic, unless uncapped
+
+    // How far through the next tic to draw things.
+    fractionaltic = D_GetFractionalTic();
 
     S_UpdateSounds(players[consoleplayer].mo); // move positional sounds
 
@@ -555,6 +558,10 @@ void D_IdentifyVersion(void) {
     }
 }
 
+// The benchmarks link the game without main()
+//  and the startup helpers only main() uses.
+#ifndef BENCHMARK
+
 // Set the gamedescription string
 
 static void D_SetGameDescription(void) {
@@ -744,6 +751,16 @@ int main(int argc, char **argv) {
 
     devparm = M_CheckParm("-devparm");
 
+    //!
+    // @category video
+    //
+    // Draw frames as fast as the display allows, moving things
+    // smoothly in between tics.  The game still runs at 35 tics
+    // per second, so demos stay in sync.
+    //
+
+    uncapped = M_CheckParm("-uncapped");
+
     I_DisplayFPSDots(devparm);
 
     //!
@@ -1145,3 +1162,5 @@ int main(int argc, char **argv) {
     game_loop(); // never returns
     return 0;
 }
+
+#endif
@@ -15,10 +15,12 @@
 // DESCRIPTION:
 //
 
+#include <limits.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <unistd.h>
 
 
@@ -65,6 +67,52 @@ void I_AtExit(atexit_func_t func, boolean run_on_error) {
     exit_funcs = entry;
 }
 
+#define HUGEPAGESIZE (2 * 1024 * 1024)
+
+// -1 until the command line has been checked.
+static int use_hugepages = -1;
+
+//
+// MapRegion
+// Maps size bytes of anonymous memory for the zone, in huge pages if
+// -hugepages was given and the system has them to spare, otherwise
+// asking for transparent huge pages.
+//
+static byte *MapRegion(size_t size) {
+    void *region;
+
+    if (use_hugepages < 0) {
+        //!
+        // @category obscure
+        //
+        // Back the zone heap with huge pages where the system allows.
+        //
+
+        use_hugepages = M_ParmExists("-hugepages");
+    }
+
+    region = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+    if (use_hugepages && size % HUGEPAGESIZE == 0)
+        region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+
+    if (region == MAP_FAILED) {
+        region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+        if (region == MAP_FAILED)
+            return NULL;
+
+#ifdef MADV_HUGEPAGE
+        if (use_hugepages)
+            madvise(region, size, MADV_HUGEPAGE);
+#endif
+    }
+
+    return region;
+}
+
 // Zone memory auto-allocation function that allocates the zone size
 // by trying progressively smaller zone sizes until one is found that
 // works.
@@ -90,7 +138,7 @@ static byte *AutoAllocMemory(int *size, int default_ram, int min_ram) {
 
         *size = default_ram * 1024 * 1024;
 
-        zonemem = malloc(*size);
+        zonemem = MapRegion(*size);
 
         // Failed to allocate?  Reduce zone size until we reach a size
         // that is acceptable.
@@ -132,6 +180,22 @@ byte *I_ZoneBase(int *size) {
     return zonemem;
 }
 
+byte *I_ZoneRegion(int *size) {
+    size_t pagesize;
+
+    // Huge page multiples, so that -hugepages can use them.
+    pagesize = use_hugepages > 0 ? HUGEPAGESIZE : (size_t)sysconf(_SC_PAGESIZE);
+
+    if (*size > INT_MAX - (int)pagesize)
+        return NULL;
+
+    *size = (int)((*size + pagesize - 1) & ~(pagesize - 1));
+
+    return MapRegion(*size);
+}
+
+void I_FreeZoneRegion(byte *region, int size) { munmap(region, size); }
+
 void I_PrintBanner(const char *msg) {
     int i;
     int spaces = 35 - (strlen(msg) / 2);
@@ -34,6 +34,11 @@ void I_Init(void);
 // for the zone management.
 byte *I_ZoneBase(int *size);
 
+// Maps another region for the zone to grow into.  *size is rounded
+// up to whole pages; returns NULL if there is no memory left.
+byte *I_ZoneRegion(int *size);
+void I_FreeZoneRegion(byte *region, int size);
+
 boolean I_ConsoleStdout(void);
 
 // Asynchronous interrupt functions should maintain private queues
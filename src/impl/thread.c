@@ -0,0 +1,114 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Worker thread pool, used to split up rendering work.
+//
+
+#include "SDL.h"
+
+#include "../lib/type.h"
+#include "../misc/misc.h"
+#include "system.h"
+#include "thread.h"
+
+typedef struct {
+    SDL_Thread *thread;
+    SDL_sem *start;
+    int index;
+} worker_t;
+
+static worker_t workers[MAXWORKERS];
+static int numworkers = 1;
+
+static SDL_sem *workersdone;
+static workerfunc_t workerfunc;
+static boolean workersquit;
+
+static int WorkerThread(void *data) {
+    worker_t *worker = data;
+
+    for (;;) {
+        SDL_SemWait(worker->start);
+
+        if (workersquit)
+            break;
+
+        workerfunc(worker->index, numworkers);
+        SDL_SemPost(workersdone);
+    }
+
+    return 0;
+}
+
+static void I_ShutdownWorkers(void) {
+    int i;
+
+    workersquit = true;
+
+    for (i = 1; i < numworkers; i++) {
+        SDL_SemPost(workers[i].start);
+        SDL_WaitThread(workers[i].thread, NULL);
+        SDL_DestroySemaphore(workers[i].start);
+    }
+
+    SDL_DestroySemaphore(workersdone);
+    numworkers = 1;
+}
+
+void I_InitWorkers(int count) {
+    char name[16];
+    int i;
+
+    if (count > MAXWORKERS)
+        count = MAXWORKERS;
+
+    if (numworkers > 1 || count <= 1)
+        return;
+
+    workersdone = SDL_CreateSemaphore(0);
+
+    if (workersdone == NULL)
+        error("I_InitWorkers: %s", SDL_GetError());
+
+    for (i = 1; i < count; i++) {
+        workers[i].index = i;
+        workers[i].start = SDL_CreateSemaphore(0);
+        M_snprintf(name, sizeof(name), "worker%i", i);
+        workers[i].thread = SDL_CreateThread(WorkerThread, name, &workers[i]);
+
+        if (workers[i].start == NULL || workers[i].thread == NULL)
+            error("I_InitWorkers: %s", SDL_GetError());
+
+        numworkers = i + 1;
+    }
+
+    I_AtExit(I_ShutdownWorkers, false);
+}
+
+int I_NumWorkers(void) { return numworkers; }
+
+void I_RunWorkers(workerfunc_t func) {
+    int i;
+
+    workerfunc = func;
+
+    for (i = 1; i < numworkers; i++)
+        SDL_SemPost(workers[i].start);
+
+    func(0, numworkers);
+
+    for (i = 1; i < numworkers; i++)
+        SDL_SemWait(workersdone);
+}
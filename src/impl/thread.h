@@ -0,0 +1,36 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      System-specific worker thread pool.
+//
+
+#ifndef __I_THREAD__
+#define __I_THREAD__
+
+#define MAXWORKERS 16
+
+// Called once on every worker with its index, 0 being the caller.
+typedef void (*workerfunc_t)(int worker, int numworkers);
+
+// Start count - 1 helper threads; the caller is worker 0.
+void I_InitWorkers(int count);
+
+// Number of workers, including the calling thread.
+int I_NumWorkers(void);
+
+// Run func on every worker and wait for all of them to finish.
+void I_RunWorkers(workerfunc_t func);
+
+#endif
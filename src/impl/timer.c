@@ -56,6 +56,27 @@ int I_GetTimeMS(void) {
     return ticks - basetime;
 }
 
+//
+// Same as I_GetTime, but returns time in microseconds,
+//  read from the high resolution counter.
+//
+
+uint64_t I_GetTimeUS(void) {
+    static Uint64 basecounter = 0;
+    Uint64 counter;
+    Uint64 frequency;
+
+    counter = SDL_GetPerformanceCounter();
+    frequency = SDL_GetPerformanceFrequency();
+
+    if (basecounter == 0)
+        basecounter = counter;
+
+    counter -= basecounter;
+
+    return (counter / frequency) * 1000000 + (counter % frequency) * 1000000 / frequency;
+}
+
 // Sleep for a specified number of ms
 
 void I_Sleep(int ms) { SDL_Delay(ms); }
@@ -19,6 +19,8 @@
 #ifndef __I_TIMER__
 #define __I_TIMER__
 
+#include "../lib/type.h"
+
 #define TICRATE 35
 
 // Called by game_loop,
@@ -28,6 +30,9 @@ int I_GetTime(void);
 // returns current time in ms
 int I_GetTimeMS(void);
 
+// returns current time in microseconds
+uint64_t I_GetTimeUS(void);
+
 // Pause for a specified number of ms
 void I_Sleep(int ms);
 
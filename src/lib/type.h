@@ -38,6 +38,10 @@
 #define PRINTF_ARG_ATTR(x) __attribute__((format_arg(x)))
 #define NORETURN __attribute__((noreturn))
 
+// Per-thread storage, used for renderer state that each strip thread
+// keeps its own copy of.
+#define THREADLOCAL __thread
+
 #define PACKEDPREFIX
 
 #define PACKED_STRUCT(...) PACKEDPREFIX struct __VA_ARGS__ PACKEDATTR
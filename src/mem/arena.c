@@ -0,0 +1,151 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Bump allocator for memory that is thrown away all at once.
+//      Blocks come from the system heap rather than the zone, so an
+//      arena may be used by any one thread.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../impl/system.h"
+#include "arena.h"
+
+#define ARENA_ALIGN 16
+
+struct arenablock_s {
+    arenablock_t *next;
+    size_t size;
+    size_t used;
+    byte *data;
+};
+
+static arenablock_t *NewBlock(size_t size) {
+    arenablock_t *block;
+
+    block = malloc(sizeof(*block) + size + ARENA_ALIGN);
+
+    if (block == NULL)
+        error("Z_ArenaAlloc: failed on allocation of %" PRIuPTR " bytes", (uintptr_t)size);
+
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    block->data = (byte *)(((uintptr_t)(block + 1) + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1));
+
+    return block;
+}
+
+//
+// Z_InitArena
+//
+void Z_InitArena(arena_t *arena, size_t blocksize) {
+    arena->blocks = NULL;
+    arena->current = NULL;
+    arena->blocksize = blocksize;
+    arena->used = 0;
+    arena->peak = 0;
+}
+
+//
+// Z_ArenaAlloc
+//
+void *Z_ArenaAlloc(arena_t *arena, size_t size) {
+    arenablock_t *block;
+    void *result;
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    block = arena->current;
+
+    if (block == NULL || block->used + size > block->size) {
+        // Move on to the next kept block, or add one that fits.
+        if (block != NULL && block->next != NULL && block->next->size >= size) {
+            block = block->next;
+        } else {
+            block = NewBlock(size > arena->blocksize ? size : arena->blocksize);
+
+            if (arena->current == NULL) {
+                block->next = arena->blocks;
+                arena->blocks = block;
+            } else {
+                block->next = arena->current->next;
+                arena->current->next = block;
+            }
+        }
+
+        arena->current = block;
+    }
+
+    result = block->data + block->used;
+    block->used += size;
+
+    arena->used += size;
+
+    if (arena->used > arena->peak)
+        arena->peak = arena->used;
+
+    return result;
+}
+
+//
+// Z_ArenaGrow
+//
+void *Z_ArenaGrow(arena_t *arena, void *ptr, size_t oldsize, size_t newsize) {
+    void *result;
+
+    result = Z_ArenaAlloc(arena, newsize);
+
+    if (ptr != NULL)
+        memcpy(result, ptr, oldsize);
+
+    return result;
+}
+
+//
+// Z_ResetArena
+//
+void Z_ResetArena(arena_t *arena) {
+    arenablock_t *block;
+
+    for (block = arena->blocks; block != NULL; block = block->next)
+        block->used = 0;
+
+    arena->current = arena->blocks;
+    arena->used = 0;
+}
+
+//
+// Z_ReserveArena
+//
+void Z_ReserveArena(arena_t *arena, size_t size) {
+    arenablock_t *block;
+    arenablock_t *next;
+
+    if (arena->used != 0)
+        error("Z_ReserveArena: the arena is in use");
+
+    if (arena->blocks != NULL && arena->blocks->size >= size)
+        return;
+
+    // Swap the kept blocks for one big enough.
+    for (block = arena->blocks; block != NULL; block = next) {
+        next = block->next;
+        free(block);
+    }
+
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+    arena->blocks = arena->current = NewBlock(size > arena->blocksize ? size : arena->blocksize);
+}
@@ -0,0 +1,54 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Bump allocator for memory that is thrown away all at once.
+//
+
+#ifndef __Z_ARENA__
+#define __Z_ARENA__
+
+#include <stddef.h>
+
+typedef struct arenablock_s arenablock_t;
+
+typedef struct {
+    arenablock_t *blocks;
+    arenablock_t *current;
+
+    // default size of a new block
+    size_t blocksize;
+
+    // bytes handed out since the last reset, and the most ever
+    size_t used;
+    size_t peak;
+} arena_t;
+
+void Z_InitArena(arena_t *arena, size_t blocksize);
+
+// Returns size bytes, aligned for any type.
+void *Z_ArenaAlloc(arena_t *arena, size_t size);
+
+// Moves an arena allocation to a larger one. The old space is
+// not reused until the arena is reset.
+void *Z_ArenaGrow(arena_t *arena, void *ptr, size_t oldsize, size_t newsize);
+
+// Releases everything allocated from the arena. The blocks are kept.
+void Z_ResetArena(arena_t *arena);
+
+// Makes the first block of an arena that has just been reset hold
+// at least size bytes, so that much is allocated contiguously.
+void Z_ReserveArena(arena_t *arena, size_t size);
+
+#endif
@@ -24,6 +24,7 @@
 
 #include "../impl/system.h"
 #include "../lib/type.h"
+#include "stats.h"
 #include "zone.h"
 
 #define ZONEID 0x1d4a11
@@ -34,6 +35,7 @@ struct memblock_s {
     int id; // = ZONEID
     int tag;
     int size;
+    int site; // where it was allocated, with -zonestats
     void **user;
     memblock_t *prev;
     memblock_t *next;
@@ -78,6 +80,7 @@ static void Z_RemoveBlock(memblock_t *block) {
 //
 void Z_Init(void) {
     memset(allocated_blocks, 0, sizeof(allocated_blocks));
+    Z_InitStats();
     printf("zone memory: Using native C allocator.\n");
 }
 
@@ -99,6 +102,9 @@ void Z_Free(void *ptr) {
         *block->user = NULL;
     }
 
+    if (block->site)
+        Z_StatFree(block->site, sizeof(memblock_t) + block->size, block->tag);
+
     Z_RemoveBlock(block);
 
     // Free back to system
@@ -156,6 +162,11 @@ static boolean ClearCache(int size) {
             *block->user = NULL;
         }
 
+        if (block->site) {
+            Z_StatPurge(block->site, sizeof(memblock_t) + block->size, block->tag, block->user);
+            Z_StatFree(block->site, sizeof(memblock_t) + block->size, block->tag);
+        }
+
         free(block);
 
         block = next_block;
@@ -169,7 +180,7 @@ static boolean ClearCache(int size) {
 // You can pass a NULL user if the tag is < PU_PURGELEVEL.
 //
 
-void *Z_Malloc(int size, int tag, void *user) {
+void *Z_Malloc2(int size, int tag, void *user, const char *file, int line) {
     memblock_t *newblock;
     unsigned char *data;
     void *result;
@@ -205,6 +216,7 @@ void *Z_Malloc(int size, int tag, void *user) {
     newblock->id = ZONEID;
     newblock->user = user;
     newblock->size = size;
+    newblock->site = zonestats ? Z_StatAlloc(sizeof(memblock_t) + size, tag, user, file, line) : 0;
 
     Z_InsertBlock(newblock);
 
@@ -240,6 +252,9 @@ void Z_FreeTags(int lowtag, int hightag) {
                 *block->user = NULL;
             }
 
+            if (block->site)
+                Z_StatFree(block->site, sizeof(memblock_t) + block->size, block->tag);
+
             free(block);
 
             // Jump to the next in the chain
@@ -297,6 +312,9 @@ void Z_ChangeTag2(void *ptr, int tag, const char *file, int line) {
                 "for purgable blocks",
                 file, line);
 
+    if (block->site)
+        Z_StatChangeTag(sizeof(memblock_t) + block->size, block->tag, tag);
+
     // Remove the block from its current list, and rehook it into
     // its new list.
 
@@ -304,3 +322,32 @@ void Z_ChangeTag2(void *ptr, int tag, const char *file, int line) {
     block->tag = tag;
     Z_InsertBlock(block);
 }
+
+//
+// Z_Touch
+//
+void Z_Touch(void *ptr) {
+    memblock_t *block;
+
+    block = (memblock_t *)((byte *)ptr - sizeof(memblock_t));
+
+    if (block->id != ZONEID)
+        error("Z_Touch: block without a ZONEID!");
+
+    // The cache is cleared from the back of its list, so move the
+    //  block to the front.  Only purgable blocks are moved, so that
+    //  blocks shared with the strip threads are never written.
+    if (block->tag >= PU_PURGELEVEL && allocated_blocks[block->tag] != block) {
+        Z_RemoveBlock(block);
+        Z_InsertBlock(block);
+    }
+}
+
+//
+// Z_FreeSpace
+// The C library keeps the free space, so there is none to count.
+//
+void Z_FreeSpace(size_t *total, size_t *largest) {
+    *total = 0;
+    *largest = 0;
+}
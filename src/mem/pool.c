@@ -0,0 +1,135 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Fixed size object pools, for thinkers.  Items are carved out
+//      of large slabs in order, so objects allocated one after the
+//      other sit next to each other in memory; freed items go on a
+//      free list and are reused first.  Slabs come from the system
+//      heap and are kept until exit.
+//
+
+#include <stdlib.h>
+
+#include "../impl/system.h"
+#include "pool.h"
+
+#define POOL_ALIGN 16
+
+// Each item is preceded by the pool it belongs to, so that
+//  Z_PoolFree only needs the pointer.
+#define POOL_HEADER POOL_ALIGN
+
+struct poolslab_s {
+    poolslab_t *next;
+    int used;
+    byte *data;
+};
+
+static poolslab_t *NewSlab(pool_t *pool) {
+    poolslab_t *slab;
+    size_t size;
+
+    size = pool->itemsize * pool->slabitems;
+    slab = malloc(sizeof(*slab) + size + POOL_ALIGN);
+
+    if (slab == NULL)
+        error("Z_PoolAlloc: failed on allocation of %" PRIuPTR " bytes", (uintptr_t)size);
+
+    slab->next = NULL;
+    slab->used = 0;
+    slab->data = (byte *)(((uintptr_t)(slab + 1) + POOL_ALIGN - 1) & ~(uintptr_t)(POOL_ALIGN - 1));
+
+    return slab;
+}
+
+//
+// Z_InitPool
+//
+void Z_InitPool(pool_t *pool, size_t size, int slabitems) {
+    pool->slabs = NULL;
+    pool->current = NULL;
+    pool->freelist = NULL;
+    pool->itemsize = POOL_HEADER + ((size + POOL_ALIGN - 1) & ~(size_t)(POOL_ALIGN - 1));
+    pool->slabitems = slabitems;
+}
+
+//
+// Z_PoolAlloc
+//
+void *Z_PoolAlloc(pool_t *pool) {
+    poolslab_t *slab;
+    byte *item;
+
+    if (pool->freelist != NULL) {
+        item = pool->freelist;
+        pool->freelist = *(void **)item;
+        return item;
+    }
+
+    slab = pool->current;
+
+    if (slab == NULL || slab->used == pool->slabitems) {
+        // Move on to the next kept slab, or add one at the end.
+        if (slab != NULL && slab->next != NULL) {
+            slab = slab->next;
+        } else {
+            slab = NewSlab(pool);
+
+            if (pool->current == NULL)
+                pool->slabs = slab;
+            else
+                pool->current->next = slab;
+        }
+
+        pool->current = slab;
+    }
+
+    item = slab->data + slab->used * pool->itemsize;
+    slab->used++;
+
+    *(pool_t **)item = pool;
+
+    return item + POOL_HEADER;
+}
+
+//
+// Z_PoolFree
+//
+void Z_PoolFree(void *ptr) {
+    pool_t *pool;
+
+    pool = Z_PoolOf(ptr);
+
+    *(void **)ptr = pool->freelist;
+    pool->freelist = ptr;
+}
+
+//
+// Z_PoolOf
+//
+pool_t *Z_PoolOf(void *ptr) { return *(pool_t **)((byte *)ptr - POOL_HEADER); }
+
+//
+// Z_ResetPool
+//
+void Z_ResetPool(pool_t *pool) {
+    poolslab_t *slab;
+
+    for (slab = pool->slabs; slab != NULL; slab = slab->next)
+        slab->used = 0;
+
+    pool->current = pool->slabs;
+    pool->freelist = NULL;
+}
@@ -0,0 +1,53 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//      Fixed size object pools, for thinkers.
+//
+
+#ifndef __Z_POOL__
+#define __Z_POOL__
+
+#include <stddef.h>
+
+typedef struct poolslab_s poolslab_t;
+
+typedef struct {
+    poolslab_t *slabs;
+    poolslab_t *current;
+
+    // items given back, reused before the slabs are bumped on
+    void *freelist;
+
+    // bytes per item including its header, and items per slab
+    size_t itemsize;
+    int slabitems;
+} pool_t;
+
+void Z_InitPool(pool_t *pool, size_t size, int slabitems);
+
+// Returns an uninitialised item, aligned for any type.
+void *Z_PoolAlloc(pool_t *pool);
+
+// Gives an item back to the pool it came from.
+void Z_PoolFree(void *ptr);
+
+// Returns the pool an item came from.
+pool_t *Z_PoolOf(void *ptr);
+
+// Releases every item. The slabs are kept, and are handed out
+// again in the order they were first allocated.
+void Z_ResetPool(pool_t *pool);
+
+#endif
@@ -0,0 +1,524 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Zone memory statistics.  Counts are kept for each tag and for
+//	each site, the file and line of code a block was allocated
+//	from.  Lumps are counted under the WAD they were read from, so
+//	a PWAD thrashing the cache shows up by name.
+//
+//	A block is reloaded when it is allocated for the owner of a
+//	block purged earlier.
+//
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../impl/system.h"
+#include "../lib/argv.h"
+#include "../misc/misc.h"
+
+#include "stats.h"
+#include "zone.h"
+
+typedef struct {
+    // blocks and bytes held now, and the most bytes held
+    int blocks;
+    size_t bytes;
+    size_t peak;
+
+    // events since the level started
+    int allocs;
+    int frees;
+    int purges;
+    size_t purged;
+    int reloads;
+} zonecount_t;
+
+typedef struct {
+    const char *file;
+    int line;
+    zonecount_t count;
+} zonesite_t;
+
+typedef struct {
+    void **user;
+    int tag;
+} zoneowner_t;
+
+boolean zonestats;
+
+static zonecount_t totalcount;
+static zonecount_t tagcounts[PU_NUM_TAGS];
+
+// sites[0] is never used, so that a block's site is 0 when it has none
+static zonesite_t *sites;
+static int numsites;
+static int maxsites;
+
+// open addressed, holding indexes into sites
+static int *sitehash;
+static int sitehashsize;
+
+// owners of purged blocks, open addressed
+static zoneowner_t *owners;
+static int numowners;
+static int ownerhashsize;
+
+static FILE *statsfile;
+
+static const char *tagnames[PU_NUM_TAGS] = {
+    "", "PU_STATIC", "PU_SOUND", "PU_MUSIC", "PU_FREE", "PU_LEVEL", "PU_LEVSPEC", "PU_PURGELEVEL", "PU_CACHE",
+};
+
+static unsigned int HashSite(const char *file, int line) {
+    unsigned int hash = line * 2654435761u;
+
+    while (*file != '\0')
+        hash = hash * 31 + (unsigned char)*file++;
+
+    return hash;
+}
+
+//
+// RehashSites
+// Doubles the hash table; it is kept at most half full.
+//
+static void RehashSites(void) {
+    unsigned int slot;
+    int i;
+
+    sitehashsize = sitehashsize ? sitehashsize * 2 : 256;
+    sitehash = I_Realloc(sitehash, sitehashsize * sizeof(*sitehash));
+    memset(sitehash, 0, sitehashsize * sizeof(*sitehash));
+
+    for (i = 1; i < numsites; i++) {
+        slot = HashSite(sites[i].file, sites[i].line) & (sitehashsize - 1);
+
+        while (sitehash[slot] != 0)
+            slot = (slot + 1) & (sitehashsize - 1);
+
+        sitehash[slot] = i;
+    }
+}
+
+//
+// FindSite
+// Returns the site for a file and line, adding it if it is new.
+//
+static int FindSite(const char *file, int line) {
+    zonesite_t *site;
+    unsigned int slot;
+    int i;
+
+    slot = HashSite(file, line) & (sitehashsize - 1);
+
+    while ((i = sitehash[slot]) != 0) {
+        if (sites[i].line == line && !strcmp(sites[i].file, file))
+            return i;
+
+        slot = (slot + 1) & (sitehashsize - 1);
+    }
+
+    if (numsites == maxsites) {
+        maxsites *= 2;
+        sites = I_Realloc(sites, maxsites * sizeof(*sites));
+    }
+
+    i = numsites++;
+    site = &sites[i];
+    // a WAD's name goes away if it is reloaded
+    site->file = M_StringDuplicate(file);
+    site->line = line;
+    memset(&site->count, 0, sizeof(site->count));
+
+    if (numsites * 2 > sitehashsize)
+        RehashSites();
+    else
+        sitehash[slot] = i;
+
+    return i;
+}
+
+static unsigned int HashOwner(void **user) { return (unsigned int)((uintptr_t)user >> 3) * 2654435761u; }
+
+static void AddOwner(void **user, int tag);
+
+//
+// RehashOwners
+// Doubles the owner table; it is kept at most half full.
+//
+static void RehashOwners(void) {
+    zoneowner_t *old;
+    int oldsize;
+    int i;
+
+    old = owners;
+    oldsize = ownerhashsize;
+
+    ownerhashsize = ownerhashsize ? ownerhashsize * 2 : 1024;
+    owners = I_Realloc(NULL, ownerhashsize * sizeof(*owners));
+    memset(owners, 0, ownerhashsize * sizeof(*owners));
+    numowners = 0;
+
+    for (i = 0; i < oldsize; i++) {
+        if (old[i].user != NULL)
+            AddOwner(old[i].user, old[i].tag);
+    }
+
+    free(old);
+}
+
+//
+// AddOwner
+// Remembers the owner of a purged block.
+//
+static void AddOwner(void **user, int tag) {
+    unsigned int slot;
+
+    if ((numowners + 1) * 2 > ownerhashsize)
+        RehashOwners();
+
+    slot = HashOwner(user) & (ownerhashsize - 1);
+
+    while (owners[slot].user != NULL && owners[slot].user != user)
+        slot = (slot + 1) & (ownerhashsize - 1);
+
+    if (owners[slot].user == NULL)
+        numowners++;
+
+    owners[slot].user = user;
+    owners[slot].tag = tag;
+}
+
+//
+// RemoveOwner
+// Returns the tag of the block the owner last had purged, or 0 if
+//  it had none.
+//
+static int RemoveOwner(void **user) {
+    unsigned int slot, next, home;
+    int tag;
+
+    if (numowners == 0)
+        return 0;
+
+    slot = HashOwner(user) & (ownerhashsize - 1);
+
+    while (owners[slot].user != user) {
+        if (owners[slot].user == NULL)
+            return 0;
+
+        slot = (slot + 1) & (ownerhashsize - 1);
+    }
+
+    tag = owners[slot].tag;
+    numowners--;
+
+    // Shift back any entries after it that would no longer be found.
+    for (next = (slot + 1) & (ownerhashsize - 1); owners[next].user != NULL;
+         next = (next + 1) & (ownerhashsize - 1)) {
+        home = HashOwner(owners[next].user) & (ownerhashsize - 1);
+
+        if (((next - home) & (ownerhashsize - 1)) >= ((next - slot) & (ownerhashsize - 1))) {
+            owners[slot] = owners[next];
+            slot = next;
+        }
+    }
+
+    owners[slot].user = NULL;
+
+    return tag;
+}
+
+static void AddBlock(zonecount_t *count, int size) {
+    count->blocks++;
+    count->bytes += size;
+
+    if (count->bytes > count->peak)
+        count->peak = count->bytes;
+}
+
+static void RemoveBlock(zonecount_t *count, int size) {
+    count->blocks--;
+    count->bytes -= size;
+}
+
+static void PrintStatsAtExit(void) {
+    if (statsfile == NULL)
+        return;
+
+    fprintf(statsfile, "\nexit\n");
+    Z_FileDumpHeap(statsfile);
+    fclose(statsfile);
+    statsfile = NULL;
+}
+
+//
+// Z_InitStats
+//
+void Z_InitStats(void) {
+    const char *filename;
+    int p;
+
+    //!
+    // @category obscure
+    //
+    // Record zone memory use by tag and by the line of code that
+    // allocated it.  The IDZONE cheat shows a summary and prints the
+    // full report.
+    //
+
+    zonestats = M_ParmExists("-zonestats");
+
+    //!
+    // @category obscure
+    // @arg <file>
+    //
+    // As -zonestats, and also write the report to the given file at
+    // the end of each level and on exit.
+    //
+
+    p = M_CheckParmWithArgs("-zonestatslog", 1);
+
+    if (p) {
+        filename = myargv[p + 1];
+        statsfile = fopen(filename, "w");
+
+        if (statsfile == NULL)
+            error("Z_InitStats: couldn't open %s", filename);
+
+        zonestats = true;
+    }
+
+    if (!zonestats)
+        return;
+
+    maxsites = 256;
+    numsites = 1;
+    sites = I_Realloc(NULL, maxsites * sizeof(*sites));
+    RehashSites();
+
+    I_AtExit(PrintStatsAtExit, false);
+}
+
+//
+// Z_StatAlloc
+//
+int Z_StatAlloc(int size, int tag, void *user, const char *file, int line) {
+    int purgedtag;
+    int site;
+
+    if (!zonestats)
+        return 0;
+
+    site = FindSite(file, line);
+
+    AddBlock(&totalcount, size);
+    AddBlock(&tagcounts[tag], size);
+    AddBlock(&sites[site].count, size);
+
+    totalcount.allocs++;
+    tagcounts[tag].allocs++;
+    sites[site].count.allocs++;
+
+    if (user != NULL && (purgedtag = RemoveOwner(user)) != 0) {
+        totalcount.reloads++;
+        tagcounts[purgedtag].reloads++;
+        sites[site].count.reloads++;
+    }
+
+    return site;
+}
+
+//
+// Z_StatFree
+//
+void Z_StatFree(int site, int size, int tag) {
+    RemoveBlock(&totalcount, size);
+    RemoveBlock(&tagcounts[tag], size);
+    RemoveBlock(&sites[site].count, size);
+
+    totalcount.frees++;
+    tagcounts[tag].frees++;
+    sites[site].count.frees++;
+}
+
+//
+// Z_StatChangeTag
+//
+void Z_StatChangeTag(int size, int oldtag, int newtag) {
+    RemoveBlock(&tagcounts[oldtag], size);
+    AddBlock(&tagcounts[newtag], size);
+}
+
+//
+// Z_StatPurge
+//
+void Z_StatPurge(int site, int size, int tag, void **user) {
+    totalcount.purges++;
+    totalcount.purged += size;
+    tagcounts[tag].purges++;
+    tagcounts[tag].purged += size;
+    sites[site].count.purges++;
+    sites[site].count.purged += size;
+
+    if (user != NULL)
+        AddOwner(user, tag);
+}
+
+//
+// Fragmentation
+// Percentage of the free space that can't be had in one block.
+//
+static int Fragmentation(size_t *total, size_t *largest) {
+    Z_FreeSpace(total, largest);
+
+    if (*total == 0)
+        return 0;
+
+    return (int)(100 - *largest * 100 / *total);
+}
+
+static void PrintCount(FILE *f, const char *name, zonecount_t *count) {
+    fprintf(f, "%-32s %7i %9i %9i %8i %8i %7i %10i %8i\n", name, count->blocks, (int)(count->bytes / 1024),
+            (int)(count->peak / 1024), count->allocs, count->frees, count->purges, (int)(count->purged / 1024),
+            count->reloads);
+}
+
+static int CompareSites(const void *a, const void *b) {
+    const zonesite_t *sa = &sites[*(const int *)a];
+    const zonesite_t *sb = &sites[*(const int *)b];
+
+    if (sa->count.peak != sb->count.peak)
+        return sa->count.peak < sb->count.peak ? 1 : -1;
+
+    if (sa->count.purged != sb->count.purged)
+        return sa->count.purged < sb->count.purged ? 1 : -1;
+
+    return 0;
+}
+
+//
+// Z_FileDumpHeap
+// Writes the report: totals, then each tag, then each site by the
+//  most it has held.
+//
+void Z_FileDumpHeap(FILE *f) {
+    char name[40];
+    size_t total, largest;
+    int *order;
+    int frag;
+    int i;
+
+    if (!zonestats) {
+        fprintf(f, "zone memory: no stats without -zonestats\n");
+        return;
+    }
+
+    frag = Fragmentation(&total, &largest);
+
+    fprintf(f, "zone memory: %i KiB in %i blocks, peak %i KiB\n", (int)(totalcount.bytes / 1024),
+            totalcount.blocks, (int)(totalcount.peak / 1024));
+    fprintf(f, "free: %i KiB, largest block %i KiB, %i%% fragmented\n\n", (int)(total / 1024),
+            (int)(largest / 1024), frag);
+
+    fprintf(f, "%-32s %7s %9s %9s %8s %8s %7s %10s %8s\n", "tag / site", "blocks", "KiB", "peak KiB", "allocs",
+            "frees", "purges", "purged KiB", "reloads");
+
+    for (i = PU_STATIC; i < PU_NUM_TAGS; i++) {
+        if (i != PU_FREE)
+            PrintCount(f, tagnames[i], &tagcounts[i]);
+    }
+
+    fprintf(f, "\n");
+
+    order = I_Realloc(NULL, numsites * sizeof(*order));
+
+    for (i = 1; i < numsites; i++)
+        order[i - 1] = i;
+
+    qsort(order, numsites - 1, sizeof(*order), CompareSites);
+
+    for (i = 0; i < numsites - 1; i++) {
+        zonesite_t *site = &sites[order[i]];
+
+        if (site->count.peak == 0 && site->count.purges == 0)
+            continue;
+
+        // lumps are counted under the WAD they come from, with no line
+        if (site->line == 0)
+            M_snprintf(name, sizeof(name), "%s", site->file);
+        else
+            M_snprintf(name, sizeof(name), "%s:%i", site->file, site->line);
+
+        PrintCount(f, name, &site->count);
+    }
+
+    free(order);
+}
+
+//
+// Z_StatsSummary
+// One line for the IDZONE cheat.
+//
+void Z_StatsSummary(char *buf, size_t buf_len) {
+    size_t total, largest;
+    int frag;
+
+    if (!zonestats) {
+        M_snprintf(buf, buf_len, "no zone stats without -zonestats");
+        return;
+    }
+
+    frag = Fragmentation(&total, &largest);
+
+    M_snprintf(buf, buf_len, "zone %iK cache %iK evict %i reload %i frag %i%%", (int)(totalcount.bytes / 1024),
+               (int)(tagcounts[PU_CACHE].bytes / 1024), totalcount.purges, totalcount.reloads, frag);
+}
+
+static void ResetCount(zonecount_t *count) {
+    count->peak = count->bytes;
+    count->allocs = 0;
+    count->frees = 0;
+    count->purges = 0;
+    count->purged = 0;
+    count->reloads = 0;
+}
+
+//
+// Z_EndLevelStats
+// Writes the report for the level just left to the -zonestatslog
+//  file, and starts counting again for the next one.
+//
+void Z_EndLevelStats(const char *mapname) {
+    int i;
+
+    if (!zonestats)
+        return;
+
+    if (statsfile != NULL) {
+        fprintf(statsfile, "\n%.8s\n", mapname);
+        Z_FileDumpHeap(statsfile);
+        fflush(statsfile);
+    }
+
+    ResetCount(&totalcount);
+
+    for (i = 0; i < PU_NUM_TAGS; i++)
+        ResetCount(&tagcounts[i]);
+
+    for (i = 1; i < numsites; i++)
+        ResetCount(&sites[i].count);
+}
@@ -0,0 +1,46 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Zone memory statistics, shared by the zone allocators.  With
+//	-zonestats each block remembers the line of code that allocated
+//	it, and bytes, block counts, peaks and purges are kept by tag
+//	and by that line.
+//
+
+#ifndef __Z_STATS__
+#define __Z_STATS__
+
+#include "../lib/type.h"
+
+extern boolean zonestats;
+
+// Called from Z_Init.
+void Z_InitStats(void);
+
+// Returns the site to keep in the block, which is 0 when stats are
+// off.  The others are only called for blocks with a site.
+int Z_StatAlloc(int size, int tag, void *user, const char *file, int line);
+void Z_StatFree(int site, int size, int tag);
+void Z_StatChangeTag(int size, int oldtag, int newtag);
+
+// Counts a block thrown out to make room, before it is freed.  The
+// next block allocated for the same owner counts as a reload.
+void Z_StatPurge(int site, int size, int tag, void **user);
+
+// Implemented by each allocator: total free bytes in the zone, and
+// the biggest block that could be allocated without purging.
+void Z_FreeSpace(size_t *total, size_t *largest);
+
+#endif
@@ -0,0 +1,769 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Zone Memory Allocation with segregated free lists.
+//
+//	This is an implementation of the zone memory API in the style
+//	of TLSF (two level segregated fit): free blocks are kept in
+//	lists by size class, found through two levels of bitmaps, so
+//	allocating and freeing take constant time however big or
+//	fragmented the zone is.
+//
+
+#include <string.h>
+
+#include "../impl/system.h"
+#include "../lib/argv.h"
+#include "../lib/type.h"
+
+#include "stats.h"
+#include "zone.h"
+
+//
+// ZONE MEMORY ALLOCATION
+//
+// As in zone.c there is never any space between memblocks, and
+//  there will never be two contiguous free memblocks.
+// A free block is on the list for its size class, an allocated
+//  one on the list for its tag, newest first.  Purgable blocks are
+//  only thrown out when nothing is big enough, from the back of the
+//  list, as a clock would: one touched (Z_Touch) since it went on
+//  the list is moved to the front instead.  The unused blocks next
+//  to it go too, until the hole is big enough, so that the blocks
+//  thrown out make one hole rather than many small ones.  The zone
+//  only grows by another region after that.
+//
+// Each region ends with a fence block that is never freed, so
+//  free blocks are never merged past the end of their region.
+//
+
+#define BLOCKALIGN 16
+#define ZONEID 0x1d4a11
+#define FENCETAG 0
+#define REGIONSIZE (4 * 1024 * 1024)
+
+typedef struct memblock_s {
+    int size;   // including the header and possibly tiny fragments
+    short tag;  // PU_FREE if this is free
+    short used; // touched since it was put on its tag list
+    int id;     // should be ZONEID
+    int site;   // where it was allocated, with -zonestats
+    void **user;
+
+    // the block before this one in memory, NULL for the first
+    struct memblock_s *prevphys;
+
+    // size class list if free, tag list if not
+    struct memblock_s *next;
+    struct memblock_s *prev;
+} memblock_t;
+
+#define HEADERSIZE ((int)((sizeof(memblock_t) + BLOCKALIGN - 1) & ~(BLOCKALIGN - 1)))
+#define MINFRAGMENT (HEADERSIZE + 64)
+
+typedef struct memregion_s {
+    struct memregion_s *next;
+    int size;
+
+    memblock_t *first;
+    memblock_t *fence;
+} memregion_t;
+
+#define REGIONHEADER ((int)((sizeof(memregion_t) + BLOCKALIGN - 1) & ~(BLOCKALIGN - 1)))
+
+//
+// Size classes.  Blocks under SMALLBLOCK bytes get one list per
+//  BLOCKALIGN bytes; above that each power of two is split into
+//  SLCOUNT lists.
+//
+#define SLBITS 4
+#define SLCOUNT (1 << SLBITS)
+#define FLSHIFT 8
+#define SMALLBLOCK (1 << FLSHIFT)
+#define FLCOUNT (32 - FLSHIFT)
+
+typedef struct {
+    unsigned int flbitmap;
+    unsigned int slbitmap[FLCOUNT];
+    memblock_t *freelists[FLCOUNT][SLCOUNT];
+
+    // start / end cap for each tag's list
+    memblock_t taglists[PU_NUM_TAGS];
+
+    // the one from I_ZoneBase is last, and never given back
+    memregion_t *regions;
+    memregion_t *baseregion;
+} memzone_t;
+
+static memzone_t mainzone;
+
+// whole zone size in bytes, and number of extra regions
+static size_t zonesize, peaksize;
+static int numregions, peakregions;
+static boolean zero_on_free;
+static boolean scan_on_free;
+
+#define NEXTBLOCK(block) ((memblock_t *)((byte *)(block) + (block)->size))
+
+static int HighBit(unsigned int x) {
+#ifdef __GNUC__
+    return 31 - __builtin_clz(x);
+#else
+    int bit = 0;
+
+    while (x >>= 1)
+        bit++;
+
+    return bit;
+#endif
+}
+
+static int LowBit(unsigned int x) {
+#ifdef __GNUC__
+    return __builtin_ctz(x);
+#else
+    int bit = 0;
+
+    while (!(x & 1)) {
+        x >>= 1;
+        bit++;
+    }
+
+    return bit;
+#endif
+}
+
+//
+// Mapping
+// Finds the size class holding blocks of the given size.
+//
+static void Mapping(int size, int *fl, int *sl) {
+    int bit;
+
+    if (size < SMALLBLOCK) {
+        *fl = 0;
+        *sl = size / (SMALLBLOCK / SLCOUNT);
+    } else {
+        bit = HighBit(size);
+        *fl = bit - FLSHIFT + 1;
+        *sl = (size >> (bit - SLBITS)) ^ SLCOUNT;
+    }
+}
+
+static void InsertFree(memblock_t *block) {
+    int fl, sl;
+
+    Mapping(block->size, &fl, &sl);
+
+    block->tag = PU_FREE;
+    block->user = NULL;
+    block->prev = NULL;
+    block->next = mainzone.freelists[fl][sl];
+
+    if (block->next != NULL)
+        block->next->prev = block;
+
+    mainzone.freelists[fl][sl] = block;
+    mainzone.flbitmap |= 1u << fl;
+    mainzone.slbitmap[fl] |= 1u << sl;
+}
+
+static void RemoveFree(memblock_t *block) {
+    int fl, sl;
+
+    Mapping(block->size, &fl, &sl);
+
+    if (block->prev != NULL)
+        block->prev->next = block->next;
+    else
+        mainzone.freelists[fl][sl] = block->next;
+
+    if (block->next != NULL)
+        block->next->prev = block->prev;
+
+    if (mainzone.freelists[fl][sl] == NULL) {
+        mainzone.slbitmap[fl] &= ~(1u << sl);
+
+        if (!mainzone.slbitmap[fl])
+            mainzone.flbitmap &= ~(1u << fl);
+    }
+}
+
+//
+// FindFree
+// Returns a free block of at least the given size, from the first
+//  size class whose blocks are all big enough.
+//
+static memblock_t *FindFree(int size) {
+    unsigned int slmap, flmap;
+    int fl, sl;
+
+    if (size >= SMALLBLOCK)
+        size += (1 << (HighBit(size) - SLBITS)) - 1;
+
+    Mapping(size, &fl, &sl);
+
+    if (fl >= FLCOUNT)
+        return NULL;
+
+    slmap = mainzone.slbitmap[fl] & (~0u << sl);
+
+    if (!slmap) {
+        if (fl + 1 >= FLCOUNT)
+            return NULL;
+
+        flmap = mainzone.flbitmap & (~0u << (fl + 1));
+
+        if (!flmap)
+            return NULL;
+
+        fl = LowBit(flmap);
+        slmap = mainzone.slbitmap[fl];
+    }
+
+    sl = LowBit(slmap);
+
+    return mainzone.freelists[fl][sl];
+}
+
+static void InsertTag(memblock_t *block) {
+    memblock_t *cap = &mainzone.taglists[block->tag];
+
+    block->prev = cap;
+    block->next = cap->next;
+    cap->next->prev = block;
+    cap->next = block;
+}
+
+static void RemoveTag(memblock_t *block) {
+    block->prev->next = block->next;
+    block->next->prev = block->prev;
+}
+
+//
+// InitRegion
+// Sets up a region of the zone as one free block and its fence.
+//
+static memregion_t *InitRegion(byte *base, int size) {
+    memregion_t *region;
+    memblock_t *block;
+
+    region = (memregion_t *)(((uintptr_t)base + BLOCKALIGN - 1) & ~(uintptr_t)(BLOCKALIGN - 1));
+    size -= (byte *)region - base;
+    size &= ~(BLOCKALIGN - 1);
+
+    region->size = size;
+    region->first = (memblock_t *)((byte *)region + REGIONHEADER);
+    region->fence = (memblock_t *)((byte *)region + size - HEADERSIZE);
+
+    region->fence->size = HEADERSIZE;
+    region->fence->tag = FENCETAG;
+    region->fence->id = 0;
+    region->fence->user = NULL;
+
+    block = region->first;
+    block->size = (byte *)region->fence - (byte *)block;
+    block->prevphys = NULL;
+    block->id = 0;
+    InsertFree(block);
+
+    region->fence->prevphys = block;
+
+    region->next = mainzone.regions;
+    mainzone.regions = region;
+
+    return region;
+}
+
+//
+// AddRegion
+// Grows the zone by a region with room for a block of the given size.
+//
+static void AddRegion(int size) {
+    byte *base;
+    int regionsize;
+
+    regionsize = REGIONSIZE;
+
+    if (size > regionsize - REGIONHEADER - HEADERSIZE - BLOCKALIGN)
+        regionsize = size + REGIONHEADER + HEADERSIZE + BLOCKALIGN;
+
+    base = I_ZoneRegion(&regionsize);
+
+    if (base == NULL)
+        error("Z_Malloc: failed on allocation of %i bytes", size);
+
+    InitRegion(base, regionsize);
+
+    zonesize += regionsize;
+    numregions++;
+
+    if (zonesize > peaksize)
+        peaksize = zonesize;
+    if (numregions > peakregions)
+        peakregions = numregions;
+}
+
+//
+// ReleaseRegions
+// Gives back to the system the regions holding nothing but free
+//  and purgable blocks.
+//
+static void ReleaseRegions(void) {
+    memregion_t **link;
+    memregion_t *region;
+    memblock_t *block;
+    memblock_t *prev;
+
+    link = &mainzone.regions;
+
+    while ((region = *link) != mainzone.baseregion) {
+        for (block = region->first; block != region->fence; block = NEXTBLOCK(block)) {
+            if (block->tag != PU_FREE && block->tag < PU_PURGELEVEL)
+                break;
+        }
+
+        if (block != region->fence) {
+            link = &region->next;
+            continue;
+        }
+
+        for (block = region->first; block != region->fence; block = NEXTBLOCK(block)) {
+            if (block->tag == PU_FREE)
+                continue;
+
+            if (block->site)
+                Z_StatPurge(block->site, block->size, block->tag, block->user);
+
+            // the block is merged into the free one before it, if any
+            prev = block->prevphys;
+            Z_Free((byte *)block + HEADERSIZE);
+
+            if (prev != NULL)
+                block = prev;
+        }
+
+        // just one free block left
+        RemoveFree(region->first);
+
+        *link = region->next;
+        zonesize -= region->size;
+        numregions--;
+
+        I_FreeZoneRegion((byte *)region, region->size);
+    }
+}
+
+static void PrintZoneStats(void) {
+    printf("zone memory: peak %i KiB, %i extra regions\n", (int)(peaksize / 1024), peakregions);
+}
+
+//
+// Z_Init
+//
+void Z_Init(void) {
+    byte *base;
+    int size;
+    int i;
+
+    base = I_ZoneBase(&size);
+
+    memset(&mainzone, 0, sizeof(mainzone));
+
+    for (i = 0; i < PU_NUM_TAGS; i++)
+        mainzone.taglists[i].next = mainzone.taglists[i].prev = &mainzone.taglists[i];
+
+    mainzone.baseregion = InitRegion(base, size);
+    zonesize = peaksize = size;
+
+    // [Deliberately undocumented]
+    // Zone memory debugging flag. If set, memory is zeroed after it is freed
+    // to deliberately break any code that attempts to use it after free.
+    //
+    zero_on_free = M_ParmExists("-zonezero");
+
+    // [Deliberately undocumented]
+    // Zone memory debugging flag. If set, each time memory is freed, the zone
+    // heap is scanned to look for remaining pointers to the freed block.
+    //
+    scan_on_free = M_ParmExists("-zonescan");
+
+    I_AtExit(PrintZoneStats, false);
+
+    Z_InitStats();
+
+    printf("zone memory: Using segregated free lists.\n");
+}
+
+// Scan the zone heap for pointers within the specified range, and warn about
+// any remaining pointers.
+static void ScanForBlock(void *start, void *end) {
+    memregion_t *region;
+    memblock_t *block;
+    void **mem;
+    int i, len;
+
+    for (region = mainzone.regions; region != NULL; region = region->next) {
+        for (block = region->first; block != region->fence; block = NEXTBLOCK(block)) {
+            int tag = block->tag;
+
+            if (tag == PU_STATIC || tag == PU_LEVEL || tag == PU_LEVSPEC) {
+                // Scan for pointers on the assumption that pointers are aligned
+                // on word boundaries (word size depending on pointer size):
+                mem = (void **)((byte *)block + HEADERSIZE);
+                len = (block->size - HEADERSIZE) / sizeof(void *);
+
+                for (i = 0; i < len; ++i) {
+                    if (start <= mem[i] && mem[i] <= end) {
+                        fprintf(stderr,
+                                "%p has dangling pointer into freed block "
+                                "%p (%p -> %p)\n",
+                                mem, start, &mem[i], mem[i]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+//
+// Z_Free
+//
+void Z_Free(void *ptr) {
+    memblock_t *block;
+    memblock_t *other;
+
+    block = (memblock_t *)((byte *)ptr - HEADERSIZE);
+
+    if (block->id != ZONEID)
+        error("Z_Free: freed a pointer without ZONEID");
+
+    if (block->user != NULL) {
+        // clear the user's mark
+        *block->user = 0;
+    }
+
+    if (block->site)
+        Z_StatFree(block->site, block->size, block->tag);
+
+    RemoveTag(block);
+
+    // mark as free
+    block->tag = PU_FREE;
+    block->user = NULL;
+    block->id = 0;
+
+    // If the -zonezero flag is provided, we zero out the block on free
+    // to break code that depends on reading freed memory.
+    if (zero_on_free) {
+        memset(ptr, 0, block->size - HEADERSIZE);
+    }
+    if (scan_on_free) {
+        ScanForBlock(ptr, (byte *)ptr + block->size - HEADERSIZE);
+    }
+
+    other = NEXTBLOCK(block);
+
+    if (other->tag == PU_FREE) {
+        // merge the next free block onto the end
+        RemoveFree(other);
+        block->size += other->size;
+    }
+
+    other = block->prevphys;
+
+    if (other != NULL && other->tag == PU_FREE) {
+        // merge with previous free block
+        RemoveFree(other);
+        other->size += block->size;
+        block = other;
+    }
+
+    NEXTBLOCK(block)->prevphys = block;
+
+    InsertFree(block);
+}
+
+//
+// PurgeOne
+// Throws out a purgable block, and returns the free block it
+//  is merged into.
+//
+static memblock_t *PurgeOne(memblock_t *block) {
+    memblock_t *prev;
+
+    if (block->site)
+        Z_StatPurge(block->site, block->size, block->tag, block->user);
+
+    prev = block->prevphys;
+    Z_Free((byte *)block + HEADERSIZE);
+
+    // merged into the block before it if that was free
+    return prev != NULL && prev->tag == PU_FREE ? prev : block;
+}
+
+static boolean Unused(memblock_t *block) {
+    return block != NULL && block->tag >= PU_PURGELEVEL && !block->used;
+}
+
+//
+// PurgeBlocks
+// Throws out the oldest purgable block not used since it went on
+//  its list, then the unused ones next to it while the hole is smaller than the given
+//  size.  Returns the hole, or NULL if there was nothing to purge.
+//
+static memblock_t *PurgeBlocks(int size) {
+    memblock_t *cap;
+    memblock_t *block;
+    int tag;
+
+    for (tag = PU_NUM_TAGS - 1; tag >= PU_PURGELEVEL; tag--) {
+        cap = &mainzone.taglists[tag];
+
+        while ((block = cap->prev) != cap) {
+            if (block->used) {
+                // used since it went on the list: second chance
+                block->used = false;
+                RemoveTag(block);
+                InsertTag(block);
+                continue;
+            }
+
+            block = PurgeOne(block);
+
+            while (block->size < size) {
+                if (Unused(NEXTBLOCK(block)))
+                    block = PurgeOne(NEXTBLOCK(block));
+                else if (Unused(block->prevphys))
+                    block = PurgeOne(block->prevphys);
+                else
+                    break;
+            }
+
+            return block;
+        }
+    }
+
+    return NULL;
+}
+
+//
+// Z_Malloc
+// You can pass a NULL user if the tag is < PU_PURGELEVEL.
+//
+void *Z_Malloc2(int size, int tag, void *user, const char *file, int line) {
+    memblock_t *block;
+    memblock_t *newblock;
+    int extra;
+    void *result;
+
+    if (tag < PU_STATIC || tag >= PU_NUM_TAGS || tag == PU_FREE) {
+        error("Z_Malloc: attempted to allocate a block with an invalid "
+                "tag: %i",
+                tag);
+    }
+
+    if (user == NULL && tag >= PU_PURGELEVEL)
+        error("Z_Malloc: an owner is required for purgable blocks");
+
+    // account for size of block header
+    size = ((size + BLOCKALIGN - 1) & ~(BLOCKALIGN - 1)) + HEADERSIZE;
+
+    while ((block = FindFree(size)) == NULL) {
+        block = PurgeBlocks(size);
+
+        if (block == NULL)
+            AddRegion(size);
+        else if (block->size >= size)
+            break;
+    }
+
+    RemoveFree(block);
+
+    // found a block big enough
+    extra = block->size - size;
+
+    if (extra > MINFRAGMENT) {
+        // there will be a free fragment after the allocated block
+        newblock = (memblock_t *)((byte *)block + size);
+        newblock->size = extra;
+        newblock->prevphys = block;
+        newblock->id = 0;
+
+        NEXTBLOCK(newblock)->prevphys = newblock;
+
+        InsertFree(newblock);
+
+        block->size = size;
+    }
+
+    block->user = user;
+    block->tag = tag;
+    block->id = ZONEID;
+    block->used = false;
+    block->site = zonestats ? Z_StatAlloc(block->size, tag, user, file, line) : 0;
+    InsertTag(block);
+
+    result = (void *)((byte *)block + HEADERSIZE);
+
+    if (block->user) {
+        *block->user = result;
+    }
+
+    return result;
+}
+
+//
+// Z_FreeTags
+//
+void Z_FreeTags(int lowtag, int hightag) {
+    memblock_t *cap;
+    int tag;
+
+    if (lowtag < 0)
+        lowtag = 0;
+    if (hightag >= PU_NUM_TAGS)
+        hightag = PU_NUM_TAGS - 1;
+
+    for (tag = lowtag; tag <= hightag; tag++) {
+        if (tag == PU_FREE)
+            continue;
+
+        cap = &mainzone.taglists[tag];
+
+        while (cap->next != cap)
+            Z_Free((byte *)cap->next + HEADERSIZE);
+    }
+
+    if (lowtag <= PU_LEVEL && hightag >= PU_LEVEL)
+        ReleaseRegions();
+}
+
+//
+// Z_CheckHeap
+//
+void Z_CheckHeap(void) {
+    memregion_t *region;
+    memblock_t *block;
+    memblock_t *prev;
+    memblock_t *list;
+    int fl, sl;
+
+    for (region = mainzone.regions; region != NULL; region = region->next) {
+        prev = NULL;
+
+        for (block = region->first; block != region->fence; block = NEXTBLOCK(block)) {
+            if (block->size < HEADERSIZE || (byte *)block + block->size > (byte *)region->fence)
+                error("Z_CheckHeap: block size does not touch the next block\n");
+
+            if (block->prevphys != prev)
+                error("Z_CheckHeap: next block doesn't have proper back link\n");
+
+            if (block->tag == PU_FREE) {
+                if (prev != NULL && prev->tag == PU_FREE)
+                    error("Z_CheckHeap: two consecutive free blocks\n");
+            } else if (block->id != ZONEID) {
+                error("Z_CheckHeap: block without a ZONEID\n");
+            }
+
+            prev = block;
+        }
+
+        if (region->fence->prevphys != prev)
+            error("Z_CheckHeap: next block doesn't have proper back link\n");
+    }
+
+    for (fl = 0; fl < FLCOUNT; fl++) {
+        for (sl = 0; sl < SLCOUNT; sl++) {
+            list = mainzone.freelists[fl][sl];
+
+            if ((list != NULL) != ((mainzone.slbitmap[fl] & (1u << sl)) != 0))
+                error("Z_CheckHeap: free list bitmap out of date\n");
+
+            for (block = list; block != NULL; block = block->next) {
+                if (block->tag != PU_FREE)
+                    error("Z_CheckHeap: allocated block on a free list\n");
+            }
+        }
+
+        if ((mainzone.slbitmap[fl] != 0) != ((mainzone.flbitmap & (1u << fl)) != 0))
+            error("Z_CheckHeap: free list bitmap out of date\n");
+    }
+}
+
+//
+// Z_ChangeTag
+//
+void Z_ChangeTag2(void *ptr, int tag, const char *file, int line) {
+    memblock_t *block;
+
+    block = (memblock_t *)((byte *)ptr - HEADERSIZE);
+
+    if (block->id != ZONEID)
+        error("%s:%i: Z_ChangeTag: block without a ZONEID!", file, line);
+
+    if (tag >= PU_PURGELEVEL && block->user == NULL)
+        error("%s:%i: Z_ChangeTag: an owner is required "
+                "for purgable blocks",
+                file, line);
+
+    if (block->site)
+        Z_StatChangeTag(block->size, block->tag, tag);
+
+    // Move the block onto its new tag's list.
+    RemoveTag(block);
+    block->tag = tag;
+    InsertTag(block);
+}
+
+//
+// Z_Touch
+//
+void Z_Touch(void *ptr) {
+    memblock_t *block;
+
+    block = (memblock_t *)((byte *)ptr - HEADERSIZE);
+
+    if (block->id != ZONEID)
+        error("Z_Touch: block without a ZONEID!");
+
+    // Only purgable blocks are marked, so that blocks shared with
+    //  the strip threads are never written.
+    if (block->tag >= PU_PURGELEVEL)
+        block->used = true;
+}
+
+//
+// Z_FreeSpace
+//
+void Z_FreeSpace(size_t *total, size_t *largest) {
+    memregion_t *region;
+    memblock_t *block;
+
+    *total = 0;
+    *largest = 0;
+
+    for (region = mainzone.regions; region != NULL; region = region->next) {
+        for (block = region->first; block != region->fence; block = NEXTBLOCK(block)) {
+            if (block->tag != PU_FREE)
+                continue;
+
+            *total += block->size;
+
+            if ((size_t)block->size > *largest)
+                *largest = block->size;
+        }
+    }
+}
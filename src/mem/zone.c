@@ -22,6 +22,7 @@
 #include "../lib/argv.h"
 #include "../lib/type.h"
 
+#include "stats.h"
 #include "zone.h"
 
 //
@@ -34,15 +35,29 @@
 // It is of no value to free a cachable block,
 //  because it will get overwritten automatically if needed.
 //
+// The rover looks for a run of free and purgable blocks big enough,
+//  and only then throws out the purgable ones in it.  A purgable
+//  block used since the rover last came by (Z_Touch) ends the run
+//  and is marked as unused, like the hand of a clock, so blocks used
+//  every frame stay in and the rest go least recently used first.
+//
+// When nothing fits the zone grows by another region.  Each region
+//  starts with a fence block that is never freed or purged, so free
+//  blocks in different regions are never merged.
+//
 
 #define MEM_ALIGN sizeof(void *)
 #define ZONEID 0x1d4a11
+#define FENCETAG 0
+#define REGIONSIZE (4 * 1024 * 1024)
 
 typedef struct memblock_s {
     int size; // including the header and possibly tiny fragments
+    int site; // where it was allocated, with -zonestats
     void **user;
-    int tag; // PU_FREE if this is free
-    int id;  // should be ZONEID
+    short tag;  // PU_FREE if this is free
+    short used; // touched since the rover passed, if purgable
+    int id;     // should be ZONEID
     struct memblock_s *next;
     struct memblock_s *prev;
 } memblock_t;
@@ -58,10 +73,25 @@ typedef struct {
 
 } memzone_t;
 
+typedef struct memregion_s {
+    struct memregion_s *next;
+    int size;
+    memblock_t fence;
+} memregion_t;
+
 static memzone_t *mainzone;
+static memregion_t *regions;
+
+// whole zone size in bytes, and number of extra regions
+static size_t zonesize, peaksize;
+static int numregions, peakregions;
 static boolean zero_on_free;
 static boolean scan_on_free;
 
+static void PrintZoneStats(void) {
+    printf("zone memory: peak %i KiB, %i extra regions\n", (int)(peaksize / 1024), peakregions);
+}
+
 //
 // Z_Init
 //
@@ -98,6 +128,126 @@ void Z_Init(void) {
     // heap is scanned to look for remaining pointers to the freed block.
     //
     scan_on_free = M_ParmExists("-zonescan");
+
+    zonesize = peaksize = mainzone->size;
+    I_AtExit(PrintZoneStats, false);
+
+    Z_InitStats();
+}
+
+//
+// AddRegion
+// Grows the zone by a region with room for a block of the given
+//  size, and returns its free block.
+//
+static memblock_t *AddRegion(int size) {
+    memregion_t *region;
+    memblock_t *block;
+    int regionsize;
+
+    regionsize = REGIONSIZE;
+
+    if (size > regionsize - (int)sizeof(memregion_t))
+        regionsize = size + sizeof(memregion_t);
+
+    region = (memregion_t *)I_ZoneRegion(&regionsize);
+
+    if (region == NULL)
+        error("Z_Malloc: failed on allocation of %i bytes", size);
+
+    region->size = regionsize;
+    region->next = regions;
+    regions = region;
+
+    region->fence.size = sizeof(memblock_t);
+    region->fence.user = NULL;
+    region->fence.tag = FENCETAG;
+    region->fence.id = 0;
+
+    block = (memblock_t *)((byte *)region + sizeof(memregion_t));
+    block->size = regionsize - sizeof(memregion_t);
+    block->user = NULL;
+    block->tag = PU_FREE;
+    block->id = 0;
+
+    // link the fence and the free block in at the end of the list
+    region->fence.prev = mainzone->blocklist.prev;
+    region->fence.next = block;
+    block->prev = &region->fence;
+    block->next = &mainzone->blocklist;
+    mainzone->blocklist.prev->next = &region->fence;
+    mainzone->blocklist.prev = block;
+
+    zonesize += regionsize;
+    numregions++;
+
+    if (zonesize > peaksize)
+        peaksize = zonesize;
+    if (numregions > peakregions)
+        peakregions = numregions;
+
+    return block;
+}
+
+//
+// ReleaseRegions
+// Gives back to the system the regions holding nothing but free
+//  and purgable blocks.
+//
+static void ReleaseRegions(void) {
+    memregion_t **link;
+    memregion_t *region;
+    memblock_t *block;
+    memblock_t *prev;
+    byte *start, *end;
+
+    link = &regions;
+
+    while ((region = *link) != NULL) {
+        start = (byte *)region;
+        end = start + region->size;
+
+        // the region's blocks follow its fence in the list
+        for (block = region->fence.next; (byte *)block > start && (byte *)block < end; block = block->next) {
+            if (block->tag != PU_FREE && block->tag < PU_PURGELEVEL)
+                break;
+        }
+
+        if ((byte *)block > start && (byte *)block < end) {
+            link = &region->next;
+            continue;
+        }
+
+        for (block = region->fence.next; (byte *)block > start && (byte *)block < end;) {
+            if (block->tag == PU_FREE) {
+                block = block->next;
+                continue;
+            }
+
+            if (block->site)
+                Z_StatPurge(block->site, block->size, block->tag, block->user);
+
+            // the block may be merged into the one before it
+            prev = block->prev;
+            Z_Free((byte *)block + sizeof(memblock_t));
+            block = prev->next;
+        }
+
+        // just the fence and one free block left
+        block = region->fence.next;
+
+        if (mainzone->rover == block || mainzone->rover == &region->fence)
+            mainzone->rover = block->next;
+
+        region->fence.prev->next = block->next;
+        block->next->prev = region->fence.prev;
+
+        *link = region->next;
+        zonesize -= region->size;
+        numregions--;
+
+        I_FreeZoneRegion((byte *)region, region->size);
+    }
 }
 
 // Scan the zone heap for pointers within the specified range, and warn about
@@ -149,6 +299,9 @@ void Z_Free(void *ptr) {
         *block->user = 0;
     }
 
+    if (block->site)
+        Z_StatFree(block->site, block->size, block->tag);
+
     // mark as free
     block->tag = PU_FREE;
     block->user = NULL;
@@ -195,20 +348,23 @@ void Z_Free(void *ptr) {
 //
 #define MINFRAGMENT 64
 
-void *Z_Malloc(int size, int tag, void *user) {
+void *Z_Malloc2(int size, int tag, void *user, const char *file, int line) {
     int extra;
+    int runsize;
     memblock_t *start;
     memblock_t *rover;
     memblock_t *newblock;
     memblock_t *base;
+    memblock_t *prev;
+    boolean spared;
     void *result;
 
     size = (size + MEM_ALIGN - 1) & ~(MEM_ALIGN - 1);
 
     // scan through the block list,
-    // looking for the first free block
-    // of sufficient size,
-    // throwing out any purgable blocks along the way.
+    // looking for the first run of free
+    // and unused purgable blocks
+    // of sufficient size.
 
     // account for size of block header
     size += sizeof(memblock_t);
@@ -222,32 +378,66 @@ void *Z_Malloc(int size, int tag, void *user) {
 
     rover = base;
     start = base->prev;
+    runsize = 0;
+    spared = false;
 
-    do {
+    for (;;) {
         if (rover == start) {
             // scanned all the way around the list
-            error("Z_Malloc: failed on allocation of %i bytes", size);
+            if (!spared) {
+                base = AddRegion(size);
+                break;
+            }
+
+            // the blocks spared are no longer marked as used,
+            //  so go round once more before growing the zone
+            spared = false;
         }
 
-        if (rover->tag != PU_FREE) {
-            if (rover->tag < PU_PURGELEVEL) {
-                // hit a block that can't be purged,
-                // so move base past it
-                base = rover = rover->next;
-            } else {
-                // free the rover block (adding the size to base)
-
-                // the rover can be the base block
-                base = base->prev;
-                Z_Free((byte *)rover + sizeof(memblock_t));
-                base = base->next;
-                rover = base->next;
+        if (rover->tag != PU_FREE && (rover->tag < PU_PURGELEVEL || rover->used)) {
+            if (rover->tag >= PU_PURGELEVEL) {
+                // used since the rover last came by,
+                // so spare it this time round
+                rover->used = false;
+                spared = true;
             }
-        } else {
+
+            // hit a block that can't be purged,
+            // so move base past it
+            base = rover = rover->next;
+            runsize = 0;
+            continue;
+        }
+
+        runsize += rover->size;
+        rover = rover->next;
+
+        if (runsize < size)
+            continue;
+
+        // a free block after the run is merged into it anyway
+        if (rover->tag == PU_FREE)
             rover = rover->next;
+
+        // throw out the purgable blocks in the run,
+        //  leaving one free block at base
+        for (newblock = base; newblock != rover;) {
+            if (newblock->tag == PU_FREE) {
+                newblock = newblock->next;
+                continue;
+            }
+
+            if (newblock->site)
+                Z_StatPurge(newblock->site, newblock->size, newblock->tag, newblock->user);
+
+            // the block may be merged into the one before it
+            prev = newblock->prev;
+            Z_Free((byte *)newblock + sizeof(memblock_t));
+            newblock = prev->next;
         }
 
-    } while (base->tag != PU_FREE || base->size < size);
+        break;
+    }
 
     // found a block big enough
     extra = base->size - size;
@@ -272,6 +462,8 @@ void *Z_Malloc(int size, int tag, void *user) {
 
     base->user = user;
     base->tag = tag;
+    base->used = true;
+    base->site = zonestats ? Z_StatAlloc(base->size, tag, user, file, line) : 0;
 
     result = (void *)((byte *)base + sizeof(memblock_t));
 
@@ -305,6 +497,9 @@ void Z_FreeTags(int lowtag, int hightag) {
         if (block->tag >= lowtag && block->tag <= hightag)
             Z_Free((byte *)block + sizeof(memblock_t));
     }
+
+    if (lowtag <= PU_LEVEL && hightag >= PU_LEVEL)
+        ReleaseRegions();
 }
 
 //
@@ -319,7 +514,8 @@ void Z_CheckHeap(void) {
             break;
         }
 
-        if ((byte *)block + block->size != (byte *)block->next)
+        // the next region starts anywhere
+        if ((byte *)block + block->size != (byte *)block->next && block->next->tag != FENCETAG)
             error("Z_CheckHeap: block size does not touch the next block\n");
 
         if (block->next->prev != block)
@@ -346,5 +542,46 @@ void Z_ChangeTag2(void *ptr, int tag, const char *file, int line) {
                 "for purgable blocks",
                 file, line);
 
+    if (block->site)
+        Z_StatChangeTag(block->size, block->tag, tag);
+
     block->tag = tag;
+    block->used = true;
+}
+
+//
+// Z_Touch
+//
+void Z_Touch(void *ptr) {
+    memblock_t *block;
+
+    block = (memblock_t *)((byte *)ptr - sizeof(memblock_t));
+
+    if (block->id != ZONEID)
+        error("Z_Touch: block without a ZONEID!");
+
+    // Only purgable blocks are marked, so that blocks shared with
+    //  the strip threads are never written.
+    if (block->tag >= PU_PURGELEVEL)
+        block->used = true;
+}
+
+//
+// Z_FreeSpace
+//
+void Z_FreeSpace(size_t *total, size_t *largest) {
+    memblock_t *block;
+
+    *total = 0;
+    *largest = 0;
+
+    for (block = mainzone->blocklist.next; block != &mainzone->blocklist; block = block->next) {
+        if (block->tag != PU_FREE)
+            continue;
+
+        *total += block->size;
+
+        if ((size_t)block->size > *largest)
+            *largest = block->size;
+    }
 }
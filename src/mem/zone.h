@@ -47,20 +47,30 @@ enum {
 };
 
 void Z_Init(void);
-void *Z_Malloc(int size, int tag, void *ptr);
+void *Z_Malloc2(int size, int tag, void *ptr, const char *file, int line);
 void Z_Free(void *ptr);
 void Z_FreeTags(int lowtag, int hightag);
 void Z_DumpHeap(int lowtag, int hightag);
 void Z_FileDumpHeap(FILE *f);
 void Z_CheckHeap(void);
 void Z_ChangeTag2(void *ptr, int tag, const char *file, int line);
+
+// Marks a block as just used.  Purgable blocks are purged least
+// recently used first; changing the tag also counts as a use.
+void Z_Touch(void *ptr);
 int Z_FreeMemory(void);
 unsigned int Z_ZoneSize(void);
 
+// Zone statistics, recorded with -zonestats.  Z_FileDumpHeap writes
+// the full report.
+void Z_StatsSummary(char *buf, size_t buf_len);
+void Z_EndLevelStats(const char *mapname);
+
 //
 // This is used to get the local FILE:LINE info from CPP
 // prior to really call the function in question.
 //
+#define Z_Malloc(s, t, u) Z_Malloc2((s), (t), (u), __FILE__, __LINE__)
 #define Z_ChangeTag(p, t) Z_ChangeTag2((p), (t), __FILE__, __LINE__)
 
 #endif
@@ -32,7 +32,8 @@
 // CEILINGS
 //
 
-ceiling_t *activeceilings[MAXCEILINGS];
+ceiling_t *activeceilings[TAGCHAINS];
+int numactiveceilings;
 
 //
 // T_MoveCeiling
@@ -160,7 +161,7 @@ int EV_DoCeiling(line_t *line, ceiling_e type) {
 
         // new door thinker
         rtn = 1;
-        ceiling = Z_Malloc(sizeof(*ceiling), PU_LEVSPEC, 0);
+        ceiling = Z_PoolAlloc(&ceilingpool);
         P_AddThinker(&ceiling->thinker);
         sec->specialdata = ceiling;
         ceiling->thinker.function.acp1 = (actionf_p1)T_MoveCeiling;
@@ -205,45 +206,62 @@ int EV_DoCeiling(line_t *line, ceiling_e type) {
 
 //
 // Add an active ceiling
+// With -speciallimits, ceilings past the vanilla limit are left off
+// the list, so they can't be stopped and never finish.
 //
 void P_AddActiveCeiling(ceiling_t *c) {
-    int i;
+    ceiling_t **chain;
 
-    for (i = 0; i < MAXCEILINGS; i++) {
-        if (activeceilings[i] == NULL) {
-            activeceilings[i] = c;
-            return;
-        }
-    }
+    c->active = false;
+
+    if (speciallimits && numactiveceilings == MAXCEILINGS)
+        return;
+
+    chain = &activeceilings[TAGCHAIN(c->tag)];
+
+    c->tagprev = NULL;
+    c->tagnext = *chain;
+
+    if (*chain)
+        (*chain)->tagprev = c;
+
+    *chain = c;
+    c->active = true;
+    numactiveceilings++;
 }
 
 //
 // Remove a ceiling's thinker
 //
 void P_RemoveActiveCeiling(ceiling_t *c) {
-    int i;
+    if (!c->active)
+        return;
 
-    for (i = 0; i < MAXCEILINGS; i++) {
-        if (activeceilings[i] == c) {
-            activeceilings[i]->sector->specialdata = NULL;
-            P_RemoveThinker(&activeceilings[i]->thinker);
-            activeceilings[i] = NULL;
-            break;
-        }
-    }
+    c->sector->specialdata = NULL;
+    P_RemoveThinker(&c->thinker);
+
+    if (c->tagprev)
+        c->tagprev->tagnext = c->tagnext;
+    else
+        activeceilings[TAGCHAIN(c->tag)] = c->tagnext;
+
+    if (c->tagnext)
+        c->tagnext->tagprev = c->tagprev;
+
+    c->active = false;
+    numactiveceilings--;
 }
 
 //
 // Restart a ceiling that's in-stasis
 //
 void P_ActivateInStasisCeiling(line_t *line) {
-    int i;
+    ceiling_t *c;
 
-    for (i = 0; i < MAXCEILINGS; i++) {
-        if (activeceilings[i] && (activeceilings[i]->tag == line->tag) &&
-            (activeceilings[i]->direction == 0)) {
-            activeceilings[i]->direction = activeceilings[i]->olddirection;
-            activeceilings[i]->thinker.function.acp1 = (actionf_p1)T_MoveCeiling;
+    for (c = activeceilings[TAGCHAIN(line->tag)]; c != NULL; c = c->tagnext) {
+        if (c->tag == line->tag && c->direction == 0) {
+            c->direction = c->olddirection;
+            c->thinker.function.acp1 = (actionf_p1)T_MoveCeiling;
         }
     }
 }
@@ -253,16 +271,15 @@ void P_ActivateInStasisCeiling(line_t *line) {
 // Stop a ceiling from crushing!
 //
 int EV_CeilingCrushStop(line_t *line) {
-    int i;
+    ceiling_t *c;
     int rtn;
 
     rtn = 0;
-    for (i = 0; i < MAXCEILINGS; i++) {
-        if (activeceilings[i] && (activeceilings[i]->tag == line->tag) &&
-            (activeceilings[i]->direction != 0)) {
-            activeceilings[i]->olddirection = activeceilings[i]->direction;
-            activeceilings[i]->thinker.function.acv = (actionf_v)NULL;
-            activeceilings[i]->direction = 0; // in-stasis
+    for (c = activeceilings[TAGCHAIN(line->tag)]; c != NULL; c = c->tagnext) {
+        if (c->tag == line->tag && c->direction != 0) {
+            c->olddirection = c->direction;
+            c->thinker.function.acv = (actionf_v)NULL;
+            c->direction = 0; // in-stasis
             rtn = 1;
         }
     }
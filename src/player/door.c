@@ -209,7 +209,7 @@ int EV_DoDoor(line_t *line, vldoor_e type) {
 
         // new door thinker
         rtn = 1;
-        door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+        door = Z_PoolAlloc(&doorpool);
         P_AddThinker(&door->thinker);
         sec->specialdata = door;
 
@@ -393,7 +393,7 @@ void EV_VerticalDoor(line_t *line, mobj_t *thing) {
     }
 
     // new door thinker
-    door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+    door = Z_PoolAlloc(&doorpool);
     P_AddThinker(&door->thinker);
     sec->specialdata = door;
     door->thinker.function.acp1 = (actionf_p1)T_VerticalDoor;
@@ -440,7 +440,7 @@ void EV_VerticalDoor(line_t *line, mobj_t *thing) {
 void P_SpawnDoorCloseIn30(sector_t *sec) {
     vldoor_t *door;
 
-    door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+    door = Z_PoolAlloc(&doorpool);
 
     P_AddThinker(&door->thinker);
 
@@ -461,7 +461,7 @@ void P_SpawnDoorCloseIn30(sector_t *sec) {
 void P_SpawnDoorRaiseIn5Mins(sector_t *sec) {
     vldoor_t *door;
 
-    door = Z_Malloc(sizeof(*door), PU_LEVSPEC, 0);
+    door = Z_PoolAlloc(&doorpool);
 
     P_AddThinker(&door->thinker);
 
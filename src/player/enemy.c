@@ -70,19 +70,26 @@ void A_Fall(mobj_t *actor);
 // but some can be made preaware
 //
 
-//
-// Called by P_NoiseAlert.
-// Recursively traverse adjacent sectors,
-// sound blocking lines cut off traversal.
-//
-
 mobj_t *soundtarget;
 
-void P_RecursiveSound(sector_t *sec, int soundblocks) {
-    int i;
-    line_t *check;
-    sector_t *other;
+// Sectors waiting to pass the sound on, breadth first.  A sector
+//  is queued again only when it is reached through fewer sound
+//  blocking lines, so each one is queued at most twice.
+typedef struct {
+    sector_t *sector;
+    int soundblocks;
+} soundnode_t;
 
+static soundnode_t *soundqueue;
+static int soundqueuesize;
+static int soundtail;
+
+//
+// P_FloodSector
+// Marks a sector as hearing the sound and queues it, unless it
+//  has already heard it through as few sound blocking lines.
+//
+static void P_FloodSector(sector_t *sec, int soundblocks) {
     // wake up all monsters in this sector
     if (sec->validcount == validcount && sec->soundtraversed <= soundblocks + 1) {
         return; // already flooded
@@ -92,26 +99,60 @@ void P_RecursiveSound(sector_t *sec, int soundblocks) {
     sec->soundtraversed = soundblocks + 1;
     sec->soundtarget = soundtarget;
 
-    for (i = 0; i < sec->linecount; i++) {
-        check = sec->lines[i];
-        if (!(check->flags & ML_TWOSIDED))
+    soundqueue[soundtail].sector = sec;
+    soundqueue[soundtail].soundblocks = soundblocks;
+    soundtail++;
+}
+
+//
+// P_PropagateSound
+// Called by P_NoiseAlert.
+// Traverses adjacent sectors, sound blocking lines cut off
+//  traversal.  Leaves the same sectors marked as vanilla's
+//  recursive flood, without the recursion.
+//
+static void P_PropagateSound(sector_t *sec) {
+    sectoradj_t *adj;
+    sector_t *other;
+    fixed_t top, bottom;
+    int soundblocks;
+    int head;
+    int i;
+
+    if (soundqueuesize < numsectors * 2) {
+        soundqueuesize = numsectors * 2;
+        soundqueue = I_Realloc(soundqueue, soundqueuesize * sizeof(*soundqueue));
+    }
+
+    head = soundtail = 0;
+    P_FloodSector(sec, 0);
+
+    while (head < soundtail) {
+        sec = soundqueue[head].sector;
+        soundblocks = soundqueue[head].soundblocks;
+        head++;
+
+        // Reached again through fewer blocking lines since this
+        //  was queued; that later entry does the work.
+        if (sec->soundtraversed != soundblocks + 1)
             continue;
 
-        P_LineOpening(check);
+        for (i = 0, adj = sec->adjacent; i < sec->adjacentcount; i++, adj++) {
+            other = adj->sector;
 
-        if (openrange <= 0)
-            continue; // closed door
+            // P_LineOpening, without touching its globals
+            top = sec->ceilingheight < other->ceilingheight ? sec->ceilingheight : other->ceilingheight;
+            bottom = sec->floorheight > other->floorheight ? sec->floorheight : other->floorheight;
 
-        if (sides[check->sidenum[0]].sector == sec)
-            other = sides[check->sidenum[1]].sector;
-        else
-            other = sides[check->sidenum[0]].sector;
+            if (top - bottom <= 0)
+                continue; // closed door
 
-        if (check->flags & ML_SOUNDBLOCK) {
-            if (!soundblocks)
-                P_RecursiveSound(other, 1);
-        } else
-            P_RecursiveSound(other, soundblocks);
+            if (adj->soundblock) {
+                if (!soundblocks)
+                    P_FloodSector(other, 1);
+            } else
+                P_FloodSector(other, soundblocks);
+        }
     }
 }
 
@@ -123,7 +164,7 @@ void P_RecursiveSound(sector_t *sec, int soundblocks) {
 void P_NoiseAlert(mobj_t *target, mobj_t *emmiter) {
     soundtarget = target;
     validcount++;
-    P_RecursiveSound(emmiter->subsector->sector, 0);
+    P_PropagateSound(emmiter->subsector->sector);
 }
 
 //
@@ -411,18 +452,18 @@ boolean P_LookForPlayers(mobj_t *actor, boolean allaround) {
     fixed_t dist;
 
     c = 0;
-    stop = (actor->lastlook - 1) & 3;
+    stop = (MO_LASTLOOK(actor) - 1) & 3;
 
-    for (;; actor->lastlook = (actor->lastlook + 1) & 3) {
-        if (!playeringame[actor->lastlook])
+    for (;; MO_LASTLOOK(actor) = (MO_LASTLOOK(actor) + 1) & 3) {
+        if (!playeringame[MO_LASTLOOK(actor)])
             continue;
 
-        if (c++ == 2 || actor->lastlook == stop) {
+        if (c++ == 2 || MO_LASTLOOK(actor) == stop) {
             // done looking
             return false;
         }
 
-        player = &players[actor->lastlook];
+        player = &players[MO_LASTLOOK(actor)];
 
         if (player->health <= 0)
             continue; // dead
@@ -831,7 +872,7 @@ void A_SkelMissile(mobj_t *actor) {
 
     mo->x += mo->momx;
     mo->y += mo->momy;
-    mo->tracer = actor->target;
+    MO_TRACER(mo) = actor->target;
 }
 
 int TRACEANGLE = 0xc000000;
@@ -857,7 +898,7 @@ void A_Tracer(mobj_t *actor) {
         th->tics = 1;
 
     // adjust direction
-    dest = actor->tracer;
+    dest = MO_TRACER(actor);
 
     if (!dest || dest->health <= 0)
         return;
@@ -1042,7 +1083,7 @@ void A_Fire(mobj_t *actor) {
     mobj_t *target;
     unsigned an;
 
-    dest = actor->tracer;
+    dest = MO_TRACER(actor);
     if (!dest)
         return;
 
@@ -1075,9 +1116,9 @@ void A_VileTarget(mobj_t *actor) {
 
     fog = P_SpawnMobj(actor->target->x, actor->target->x, actor->target->z, MT_FIRE);
 
-    actor->tracer = fog;
+    MO_TRACER(actor) = fog;
     fog->target = actor;
-    fog->tracer = actor->target;
+    MO_TRACER(fog) = actor->target;
     A_Fire(fog);
 }
 
@@ -1102,7 +1143,7 @@ void A_VileAttack(mobj_t *actor) {
 
     an = actor->angle >> ANGLETOFINESHIFT;
 
-    fire = actor->tracer;
+    fire = MO_TRACER(actor);
 
     if (!fire)
         return;
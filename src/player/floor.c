@@ -38,8 +38,8 @@
 //
 // Move a plane (floor or ceiling) and check for crushing
 //
-result_e T_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest, boolean crush, int floorOrCeiling,
-                     int direction) {
+static result_e P_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest, boolean crush, int floorOrCeiling,
+                            int direction) {
     boolean flag;
     fixed_t lastpos;
 
@@ -165,6 +165,25 @@ result_e T_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest, boolean crus
     return ok;
 }
 
+//
+// T_MovePlane
+// Bumps the sector version when a height really changed,
+//  so sight checks across the sector are traced again.
+//
+result_e T_MovePlane(sector_t *sector, fixed_t speed, fixed_t dest, boolean crush, int floorOrCeiling,
+                     int direction) {
+    fixed_t floorheight = sector->floorheight;
+    fixed_t ceilingheight = sector->ceilingheight;
+    result_e res;
+
+    res = P_MovePlane(sector, speed, dest, crush, floorOrCeiling, direction);
+
+    if (sector->floorheight != floorheight || sector->ceilingheight != ceilingheight)
+        sector->version++;
+
+    return res;
+}
+
 //
 // MOVE A FLOOR TO IT'S DESTINATION (UP OR DOWN)
 //
@@ -223,7 +242,7 @@ int EV_DoFloor(line_t *line, floor_e floortype) {
 
         // new floor thinker
         rtn = 1;
-        floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+        floor = Z_PoolAlloc(&floorpool);
         P_AddThinker(&floor->thinker);
         sec->specialdata = floor;
         floor->thinker.function.acp1 = (actionf_p1)T_MoveFloor;
@@ -390,7 +409,7 @@ int EV_BuildStairs(line_t *line, stair_e type) {
 
         // new floor thinker
         rtn = 1;
-        floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+        floor = Z_PoolAlloc(&floorpool);
         P_AddThinker(&floor->thinker);
         sec->specialdata = floor;
         floor->thinker.function.acp1 = (actionf_p1)T_MoveFloor;
@@ -446,7 +465,7 @@ int EV_BuildStairs(line_t *line, stair_e type) {
 
                 sec = tsec;
                 secnum = newsecnum;
-                floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+                floor = Z_PoolAlloc(&floorpool);
 
                 P_AddThinker(&floor->thinker);
 
@@ -21,6 +21,7 @@
 //
 
 #include <stdlib.h>
+#include <string.h>
 
 #include "../game/def.h"
 #include "../game/stat.h"
@@ -34,6 +35,7 @@
 
 #include "../renderer/local.h"
 #include "local.h"
+#include "setup.h"
 
 #include "../game/game.h"
 
@@ -218,16 +220,11 @@ sector_t *getNextSector(line_t *line, sector_t *sec) {
 //
 fixed_t P_FindLowestFloorSurrounding(sector_t *sec) {
     int i;
-    line_t *check;
     sector_t *other;
     fixed_t floor = sec->floorheight;
 
-    for (i = 0; i < sec->linecount; i++) {
-        check = sec->lines[i];
-        other = getNextSector(check, sec);
-
-        if (!other)
-            continue;
+    for (i = 0; i < sec->adjacentcount; i++) {
+        other = sec->adjacent[i].sector;
 
         if (other->floorheight < floor)
             floor = other->floorheight;
@@ -241,16 +238,11 @@ fixed_t P_FindLowestFloorSurrounding(sector_t *sec) {
 //
 fixed_t P_FindHighestFloorSurrounding(sector_t *sec) {
     int i;
-    line_t *check;
     sector_t *other;
     fixed_t floor = -500 * FRACUNIT;
 
-    for (i = 0; i < sec->linecount; i++) {
-        check = sec->lines[i];
-        other = getNextSector(check, sec);
-
-        if (!other)
-            continue;
+    for (i = 0; i < sec->adjacentcount; i++) {
+        other = sec->adjacent[i].sector;
 
         if (other->floorheight > floor)
             floor = other->floorheight;
@@ -272,17 +264,12 @@ fixed_t P_FindNextHighestFloor(sector_t *sec, int currentheight) {
     int i;
     int h;
     int min;
-    line_t *check;
     sector_t *other;
     fixed_t height = currentheight;
     fixed_t heightlist[MAX_ADJOINING_SECTORS + 2];
 
-    for (i = 0, h = 0; i < sec->linecount; i++) {
-        check = sec->lines[i];
-        other = getNextSector(check, sec);
-
-        if (!other)
-            continue;
+    for (i = 0, h = 0; i < sec->adjacentcount; i++) {
+        other = sec->adjacent[i].sector;
 
         if (other->floorheight > height) {
             // Emulation of memory (stack) overflow
@@ -320,16 +307,11 @@ fixed_t P_FindNextHighestFloor(sector_t *sec, int currentheight) {
 //
 fixed_t P_FindLowestCeilingSurrounding(sector_t *sec) {
     int i;
-    line_t *check;
     sector_t *other;
     fixed_t height = INT_MAX;
 
-    for (i = 0; i < sec->linecount; i++) {
-        check = sec->lines[i];
-        other = getNextSector(check, sec);
-
-        if (!other)
-            continue;
+    for (i = 0; i < sec->adjacentcount; i++) {
+        other = sec->adjacent[i].sector;
 
         if (other->ceilingheight < height)
             height = other->ceilingheight;
@@ -342,16 +324,11 @@ fixed_t P_FindLowestCeilingSurrounding(sector_t *sec) {
 //
 fixed_t P_FindHighestCeilingSurrounding(sector_t *sec) {
     int i;
-    line_t *check;
     sector_t *other;
     fixed_t height = 0;
 
-    for (i = 0; i < sec->linecount; i++) {
-        check = sec->lines[i];
-        other = getNextSector(check, sec);
-
-        if (!other)
-            continue;
+    for (i = 0; i < sec->adjacentcount; i++) {
+        other = sec->adjacent[i].sector;
 
         if (other->ceilingheight > height)
             height = other->ceilingheight;
@@ -359,15 +336,59 @@ fixed_t P_FindHighestCeilingSurrounding(sector_t *sec) {
     return height;
 }
 
+// Sector numbers sorted by tag, and by number within a tag.
+static int *tagsectors;
+
+static int CompareSectorTags(const void *a, const void *b) {
+    int s1 = *(const int *)a;
+    int s2 = *(const int *)b;
+
+    if (sectors[s1].tag != sectors[s2].tag)
+        return sectors[s1].tag - sectors[s2].tag;
+
+    return s1 - s2;
+}
+
+//
+// P_InitTagLists
+// Indexes the sectors by tag, once the level's sectors are loaded.
+//
+void P_InitTagLists(void) {
+    int i;
+
+    tagsectors = Z_ArenaAlloc(&levelarena, numsectors * sizeof(*tagsectors));
+
+    for (i = 0; i < numsectors; i++)
+        tagsectors[i] = i;
+
+    qsort(tagsectors, numsectors, sizeof(*tagsectors), CompareSectorTags);
+}
+
 //
 // RETURN NEXT SECTOR # THAT LINE TAG REFERS TO
+// Binary searches the tag index for the first sector after start,
+//  so that loops over a tag visit the sectors in the same order
+//  as a scan from start + 1 would.
 //
 int P_FindSectorFromLineTag(line_t *line, int start) {
-    int i;
+    int lo, hi, mid;
+    int sec;
 
-    for (i = start + 1; i < numsectors; i++)
-        if (sectors[i].tag == line->tag)
-            return i;
+    lo = 0;
+    hi = numsectors;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        sec = tagsectors[mid];
+
+        if (sectors[sec].tag < line->tag || (sectors[sec].tag == line->tag && sec <= start))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo < numsectors && sectors[tagsectors[lo]].tag == line->tag)
+        return tagsectors[lo];
 
     return -1;
 }
@@ -378,16 +399,11 @@ int P_FindSectorFromLineTag(line_t *line, int start) {
 int P_FindMinSurroundingLight(sector_t *sector, int max) {
     int i;
     int min;
-    line_t *line;
     sector_t *check;
 
     min = max;
-    for (i = 0; i < sector->linecount; i++) {
-        line = sector->lines[i];
-        check = getNextSector(line, sector);
-
-        if (!check)
-            continue;
+    for (i = 0; i < sector->adjacentcount; i++) {
+        check = sector->adjacent[i].sector;
 
         if (check->lightlevel < min)
             min = check->lightlevel;
@@ -976,6 +992,8 @@ void P_UpdateSpecials(void) {
     int pic;
     int i;
     line_t *line;
+    button_t *button;
+    button_t *nextbutton;
 
     //	LEVEL TIMER
     if (levelTimer == true) {
@@ -1007,27 +1025,27 @@ void P_UpdateSpecials(void) {
     }
 
     //	DO BUTTONS
-    for (i = 0; i < MAXBUTTONS; i++)
-        if (buttonlist[i].btimer) {
-            buttonlist[i].btimer--;
-            if (!buttonlist[i].btimer) {
-                switch (buttonlist[i].where) {
-                case top:
-                    sides[buttonlist[i].line->sidenum[0]].toptexture = buttonlist[i].btexture;
-                    break;
-
-                case middle:
-                    sides[buttonlist[i].line->sidenum[0]].midtexture = buttonlist[i].btexture;
-                    break;
-
-                case bottom:
-                    sides[buttonlist[i].line->sidenum[0]].bottomtexture = buttonlist[i].btexture;
-                    break;
-                }
-                S_StartSound(&buttonlist[i].soundorg, sfx_swtchn);
-                memset(&buttonlist[i], 0, sizeof(button_t));
+    for (button = buttoncap.next; button != &buttoncap; button = nextbutton) {
+        nextbutton = button->next;
+        button->btimer--;
+        if (!button->btimer) {
+            switch (button->where) {
+            case top:
+                sides[button->line->sidenum[0]].toptexture = button->btexture;
+                break;
+
+            case middle:
+                sides[button->line->sidenum[0]].midtexture = button->btexture;
+                break;
+
+            case bottom:
+                sides[button->line->sidenum[0]].bottomtexture = button->btexture;
+                break;
             }
+            S_StartSound(&button->soundorg, sfx_swtchn);
+            P_RemoveButton(button);
         }
+    }
 }
 
 //
@@ -1175,7 +1193,7 @@ int EV_DoDonut(line_t *line) {
             }
 
             //	Spawn rising slime
-            floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+            floor = Z_PoolAlloc(&floorpool);
             P_AddThinker(&floor->thinker);
             s2->specialdata = floor;
             floor->thinker.function.acp1 = (actionf_p1)T_MoveFloor;
@@ -1189,7 +1207,7 @@ int EV_DoDonut(line_t *line) {
             floor->floordestheight = s3_floorheight;
 
             //	Spawn lowering donut-hole
-            floor = Z_Malloc(sizeof(*floor), PU_LEVSPEC, 0);
+            floor = Z_PoolAlloc(&floorpool);
             P_AddThinker(&floor->thinker);
             s1->specialdata = floor;
             floor->thinker.function.acp1 = (actionf_p1)T_MoveFloor;
@@ -1323,14 +1341,23 @@ void P_SpawnSpecials(void) {
     }
 
     //	Init other misc stuff
-    for (i = 0; i < MAXCEILINGS; i++)
-        activeceilings[i] = NULL;
+    memset(activeceilings, 0, sizeof(activeceilings));
+    numactiveceilings = 0;
+
+    memset(activeplats, 0, sizeof(activeplats));
+    numactiveplats = 0;
+
+    P_ClearButtons();
 
-    for (i = 0; i < MAXPLATS; i++)
-        activeplats[i] = NULL;
+    //!
+    // @category compat
+    //
+    // Limit active platforms and crushers to 30 and pressed switches
+    // to 16, as in Vanilla Doom.  Crushers over the limit can't be
+    // stopped.  Always on for demos and netgames.
+    //
 
-    for (i = 0; i < MAXBUTTONS; i++)
-        memset(&buttonlist[i], 0, sizeof(button_t));
+    speciallimits = M_ParmExists("-speciallimits") || demoplayback || demorecording || netgame;
 
     // UNUSED: no horizonal sliders.
     //	P_InitSlidingDoorFrames();
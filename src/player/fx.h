@@ -63,6 +63,7 @@ fixed_t P_FindNextHighestFloor(sector_t *sec, int currentheight);
 fixed_t P_FindLowestCeilingSurrounding(sector_t *sec);
 fixed_t P_FindHighestCeilingSurrounding(sector_t *sec);
 
+void P_InitTagLists(void);
 int P_FindSectorFromLineTag(line_t *line, int start);
 
 int P_FindMinSurroundingLight(sector_t *sector, int max);
@@ -154,29 +155,46 @@ typedef enum {
 
 } bwhere_e;
 
-typedef struct {
+typedef struct button_s {
     line_t *line;
     bwhere_e where;
     int btexture;
     int btimer;
     degenmobj_t *soundorg;
 
+    // links in the active button list, oldest first
+    struct button_s *prev;
+    struct button_s *next;
+
 } button_t;
 
 // max # of wall switches in a level
 #define MAXSWITCHES 50
 
 // 4 players, 4 buttons each at once, max.
+// Only enforced with -speciallimits.
 #define MAXBUTTONS 16
 
 // 1 second, in ticks.
 #define BUTTONTIME 35
 
-extern button_t buttonlist[MAXBUTTONS];
+// Sentinel of the active button list.
+extern button_t buttoncap;
+extern int numbuttons;
+
+// Enforce the vanilla limits on active plats, ceilings and buttons.
+extern boolean speciallimits;
+
+// Active plats and ceilings are chained by tag, so the specials that
+// stop and restart them only walk the chain for their line's tag.
+#define TAGCHAINS 64
+#define TAGCHAIN(tag) ((tag) & (TAGCHAINS - 1))
 
 void P_ChangeSwitchTexture(line_t *line, int useAgain);
 
 void P_InitSwitchList(void);
+void P_ClearButtons(void);
+void P_RemoveButton(button_t *button);
 
 //
 // P_PLATS
@@ -198,7 +216,7 @@ typedef enum {
 
 } plattype_e;
 
-typedef struct {
+typedef struct plat_s {
     thinker_t thinker;
     sector_t *sector;
     fixed_t speed;
@@ -212,13 +230,21 @@ typedef struct {
     int tag;
     plattype_e type;
 
+    // links in the active plats chain for the tag
+    boolean active;
+    struct plat_s *tagprev;
+    struct plat_s *tagnext;
+
 } plat_t;
 
 #define PLATWAIT 3
 #define PLATSPEED FRACUNIT
+
+// Only enforced with -speciallimits.
 #define MAXPLATS 30
 
-extern plat_t *activeplats[MAXPLATS];
+extern plat_t *activeplats[TAGCHAINS];
+extern int numactiveplats;
 
 void T_PlatRaise(plat_t *plat);
 
@@ -289,7 +315,7 @@ typedef enum {
 
 } ceiling_e;
 
-typedef struct {
+typedef struct ceiling_s {
     thinker_t thinker;
     ceiling_e type;
     sector_t *sector;
@@ -305,13 +331,21 @@ typedef struct {
     int tag;
     int olddirection;
 
+    // links in the active ceilings chain for the tag
+    boolean active;
+    struct ceiling_s *tagprev;
+    struct ceiling_s *tagnext;
+
 } ceiling_t;
 
 #define CEILSPEED FRACUNIT
 #define CEILWAIT 150
+
+// Only enforced with -speciallimits.
 #define MAXCEILINGS 30
 
-extern ceiling_t *activeceilings[MAXCEILINGS];
+extern ceiling_t *activeceilings[TAGCHAINS];
+extern int numactiveceilings;
 
 int EV_DoCeiling(line_t *line, ceiling_e type);
 
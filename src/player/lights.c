@@ -59,7 +59,7 @@ void P_SpawnFireFlicker(sector_t *sector) {
     // Nothing special about it during gameplay.
     sector->special = 0;
 
-    flick = Z_Malloc(sizeof(*flick), PU_LEVSPEC, 0);
+    flick = Z_PoolAlloc(&fireflickerpool);
 
     P_AddThinker(&flick->thinker);
 
@@ -102,7 +102,7 @@ void P_SpawnLightFlash(sector_t *sector) {
     // nothing special about it during gameplay
     sector->special = 0;
 
-    flash = Z_Malloc(sizeof(*flash), PU_LEVSPEC, 0);
+    flash = Z_PoolAlloc(&lightflashpool);
 
     P_AddThinker(&flash->thinker);
 
@@ -144,7 +144,7 @@ void T_StrobeFlash(strobe_t *flash) {
 void P_SpawnStrobeFlash(sector_t *sector, int fastOrSlow, int inSync) {
     strobe_t *flash;
 
-    flash = Z_Malloc(sizeof(*flash), PU_LEVSPEC, 0);
+    flash = Z_PoolAlloc(&strobepool);
 
     P_AddThinker(&flash->thinker);
 
@@ -189,27 +189,21 @@ void EV_StartLightStrobing(line_t *line) {
 //
 void EV_TurnTagLightsOff(line_t *line) {
     int i;
-    int j;
+    int secnum;
     int min;
     sector_t *sector;
     sector_t *tsec;
-    line_t *templine;
-
-    sector = sectors;
-
-    for (j = 0; j < numsectors; j++, sector++) {
-        if (sector->tag == line->tag) {
-            min = sector->lightlevel;
-            for (i = 0; i < sector->linecount; i++) {
-                templine = sector->lines[i];
-                tsec = getNextSector(templine, sector);
-                if (!tsec)
-                    continue;
-                if (tsec->lightlevel < min)
-                    min = tsec->lightlevel;
-            }
-            sector->lightlevel = min;
+
+    secnum = -1;
+    while ((secnum = P_FindSectorFromLineTag(line, secnum)) >= 0) {
+        sector = &sectors[secnum];
+        min = sector->lightlevel;
+        for (i = 0; i < sector->adjacentcount; i++) {
+            tsec = sector->adjacent[i].sector;
+            if (tsec->lightlevel < min)
+                min = tsec->lightlevel;
         }
+        sector->lightlevel = min;
     }
 }
 
@@ -217,33 +211,27 @@ void EV_TurnTagLightsOff(line_t *line) {
 // TURN LINE'S TAG LIGHTS ON
 //
 void EV_LightTurnOn(line_t *line, int bright) {
-    int i;
+    int secnum;
     int j;
     sector_t *sector;
     sector_t *temp;
-    line_t *templine;
-
-    sector = sectors;
-
-    for (i = 0; i < numsectors; i++, sector++) {
-        if (sector->tag == line->tag) {
-            // bright = 0 means to search
-            // for highest light level
-            // surrounding sector
-            if (!bright) {
-                for (j = 0; j < sector->linecount; j++) {
-                    templine = sector->lines[j];
-                    temp = getNextSector(templine, sector);
-
-                    if (!temp)
-                        continue;
-
-                    if (temp->lightlevel > bright)
-                        bright = temp->lightlevel;
-                }
+
+    secnum = -1;
+    while ((secnum = P_FindSectorFromLineTag(line, secnum)) >= 0) {
+        sector = &sectors[secnum];
+
+        // bright = 0 means to search
+        // for highest light level
+        // surrounding sector
+        if (!bright) {
+            for (j = 0; j < sector->adjacentcount; j++) {
+                temp = sector->adjacent[j].sector;
+
+                if (temp->lightlevel > bright)
+                    bright = temp->lightlevel;
             }
-            sector->lightlevel = bright;
         }
+        sector->lightlevel = bright;
     }
 }
 
@@ -276,7 +264,7 @@ void T_Glow(glow_t *g) {
 void P_SpawnGlowingLight(sector_t *sector) {
     glow_t *g;
 
-    g = Z_Malloc(sizeof(*g), PU_LEVSPEC, 0);
+    g = Z_PoolAlloc(&glowpool);
 
     P_AddThinker(&g->thinker);
 
@@ -23,6 +23,8 @@
 #include "../renderer/local.h"
 #endif
 
+#include "../mem/pool.h"
+
 #define FLOATSPEED (FRACUNIT * 4)
 
 #define MAXHEALTH 100
@@ -61,6 +63,20 @@
 // both the head and tail of the thinker list
 extern thinker_t thinkercap;
 
+extern pool_t mobjpool;
+extern pool_t mobjcoldpool;
+extern pool_t secnodepool;
+extern pool_t ceilingpool;
+extern pool_t doorpool;
+extern pool_t floorpool;
+extern pool_t platpool;
+extern pool_t fireflickerpool;
+extern pool_t lightflashpool;
+extern pool_t strobepool;
+extern pool_t glowpool;
+
+void P_InitThinkerPools(void);
+
 void P_InitThinkers(void);
 void P_AddThinker(thinker_t *thinker);
 void P_RemoveThinker(thinker_t *thinker);
@@ -96,6 +112,7 @@ void P_RespawnSpecials(void);
 mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type);
 
 void P_RemoveMobj(mobj_t *th);
+void P_ResetInterpolation(mobj_t *mobj);
 mobj_t *P_SubstNullMobj(mobj_t *th);
 boolean P_SetMobjState(mobj_t *mobj, statenum_t state);
 void P_MobjThinker(mobj_t *mobj);
@@ -130,14 +147,17 @@ typedef struct {
     } d;
 } intercept_t;
 
-// Extended MAXINTERCEPTS, to allow for intercepts overrun emulation.
+// Vanilla's intercepts table size; intercepts[] starts with room for
+//  the overrun emulation and grows when a trace crosses more.
 
 #define MAXINTERCEPTS_ORIGINAL 128
 #define MAXINTERCEPTS (MAXINTERCEPTS_ORIGINAL + 61)
 
-extern intercept_t intercepts[MAXINTERCEPTS];
+extern intercept_t *intercepts;
 extern intercept_t *intercept_p;
 
+void P_InitIntercepts(void);
+
 typedef boolean (*traverser_t)(intercept_t *in);
 
 fixed_t P_AproxDistance(fixed_t dx, fixed_t dy);
@@ -200,6 +220,8 @@ boolean P_TryMove(mobj_t *thing, fixed_t x, fixed_t y);
 boolean P_TeleportMove(mobj_t *thing, fixed_t x, fixed_t y);
 void P_SlideMove(mobj_t *mo);
 boolean P_CheckSight(mobj_t *t1, mobj_t *t2);
+void P_InvalidateSightCache(void);
+void P_InitSight(void);
 void P_UseLines(player_t *player);
 
 boolean P_ChangeSector(sector_t *sector, boolean crunch);
@@ -221,8 +243,29 @@ extern short *blockmap;
 extern int bmapwidth;
 extern int bmapheight; // in mapblocks
 extern fixed_t bmaporgx;
-extern fixed_t bmaporgy;    // origin of block map
-extern mobj_t **blocklinks; // for thing chains
+extern fixed_t bmaporgy; // origin of block map
+
+// Things in a mapblock, oldest first.
+typedef struct {
+    mobj_t **things;
+    int count;
+    int size;
+} blockthings_t;
+
+extern blockthings_t *blockthings; // for thing lists
+extern boolean unorderedblocks;
+
+// A blockmap thing touching a sector.  Linked into the sector's
+//  touchlist and into the thing's touchnodes.
+typedef struct secnode_s {
+    sector_t *sector;
+    mobj_t *thing;
+    struct secnode_s *nextsector; // next sector touched by the thing
+    struct secnode_s *prevthing;  // links in the sector's touchlist
+    struct secnode_s *nextthing;
+} secnode_t;
+
+extern boolean sectortouchlists;
 
 //
 // P_INTER
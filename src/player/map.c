@@ -1202,10 +1202,22 @@ boolean PIT_ChangeSector(mobj_t *thing) {
 boolean P_ChangeSector(sector_t *sector, boolean crunch) {
     int x;
     int y;
+    secnode_t *node;
+    secnode_t *next;
 
     nofit = false;
     crushchange = crunch;
 
+    // re-check heights for the things touching the moving sector
+    if (sectortouchlists) {
+        for (node = sector->touchlist; node != NULL; node = next) {
+            next = node->nextthing;
+            PIT_ChangeSector(node->thing);
+        }
+
+        return nofit;
+    }
+
     // re-check heights for all things near the moving sector
     for (x = sector->blockbox[BOXLEFT]; x <= sector->blockbox[BOXRIGHT]; x++)
         for (y = sector->blockbox[BOXBOTTOM]; y <= sector->blockbox[BOXTOP]; y++)
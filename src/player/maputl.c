@@ -21,7 +21,11 @@
 //
 
 #include <stdlib.h>
+#include <string.h>
 
+#include "../impl/system.h"
+#include "../lib/argv.h"
+#include "../mem/zone.h"
 #include "../misc/bbox.h"
 
 #include "../game/def.h"
@@ -275,6 +279,118 @@ void P_LineOpening(line_t *linedef) {
 // THING POSITION SETTING
 //
 
+//
+// SECTOR TOUCH LISTS
+// Every thing in the blockmap is listed in each sector its box
+//  touches, so that P_ChangeSector only visits the things a moving
+//  plane can affect.  The sectors are found the way P_CheckPosition
+//  finds the heights it clips to: the thing's own sector and both
+//  sides of every line its box crosses.
+//
+
+//
+// P_AddTouchNode
+//
+static void P_AddTouchNode(mobj_t *thing, sector_t *sec) {
+    secnode_t *node;
+
+    for (node = thing->touchnodes; node != NULL; node = node->nextsector) {
+        if (node->sector == sec)
+            return;
+    }
+
+    node = Z_PoolAlloc(&secnodepool);
+    node->sector = sec;
+    node->thing = thing;
+
+    node->nextsector = thing->touchnodes;
+    thing->touchnodes = node;
+
+    node->prevthing = NULL;
+    node->nextthing = sec->touchlist;
+
+    if (sec->touchlist)
+        sec->touchlist->prevthing = node;
+
+    sec->touchlist = node;
+}
+
+//
+// P_LinkTouchNodes
+// Doesn't go through P_BlockLinesIterator: a thing can be spawned
+//  in the middle of a P_CheckPosition, whose validcount marks must
+//  not be disturbed.  A line seen in several blocks is just checked
+//  again.
+//
+static void P_LinkTouchNodes(mobj_t *thing) {
+    fixed_t bbox[4];
+    int xl, xh, yl, yh;
+    int bx, by;
+    short *list;
+    line_t *ld;
+
+    P_AddTouchNode(thing, thing->subsector->sector);
+
+    bbox[BOXTOP] = thing->y + thing->radius;
+    bbox[BOXBOTTOM] = thing->y - thing->radius;
+    bbox[BOXRIGHT] = thing->x + thing->radius;
+    bbox[BOXLEFT] = thing->x - thing->radius;
+
+    xl = (bbox[BOXLEFT] - bmaporgx) >> MAPBLOCKSHIFT;
+    xh = (bbox[BOXRIGHT] - bmaporgx) >> MAPBLOCKSHIFT;
+    yl = (bbox[BOXBOTTOM] - bmaporgy) >> MAPBLOCKSHIFT;
+    yh = (bbox[BOXTOP] - bmaporgy) >> MAPBLOCKSHIFT;
+
+    xl = xl < 0 ? 0 : xl;
+    yl = yl < 0 ? 0 : yl;
+    xh = xh >= bmapwidth ? bmapwidth - 1 : xh;
+    yh = yh >= bmapheight ? bmapheight - 1 : yh;
+
+    for (bx = xl; bx <= xh; bx++) {
+        for (by = yl; by <= yh; by++) {
+            for (list = blockmaplump + blockmap[by * bmapwidth + bx]; *list != -1; list++) {
+                ld = &lines[*list];
+
+                if (bbox[BOXRIGHT] <= ld->bbox[BOXLEFT] || bbox[BOXLEFT] >= ld->bbox[BOXRIGHT] ||
+                    bbox[BOXTOP] <= ld->bbox[BOXBOTTOM] || bbox[BOXBOTTOM] >= ld->bbox[BOXTOP])
+                    continue;
+
+                if (P_BoxOnLineSide(bbox, ld) != -1)
+                    continue;
+
+                P_AddTouchNode(thing, ld->frontsector);
+
+                if (ld->backsector)
+                    P_AddTouchNode(thing, ld->backsector);
+            }
+        }
+    }
+}
+
+//
+// P_UnlinkTouchNodes
+//
+static void P_UnlinkTouchNodes(mobj_t *thing) {
+    secnode_t *node;
+    secnode_t *next;
+
+    for (node = thing->touchnodes; node != NULL; node = next) {
+        next = node->nextsector;
+
+        if (node->nextthing)
+            node->nextthing->prevthing = node->prevthing;
+
+        if (node->prevthing)
+            node->prevthing->nextthing = node->nextthing;
+        else
+            node->sector->touchlist = node->nextthing;
+
+        Z_PoolFree(node);
+    }
+
+    thing->touchnodes = NULL;
+}
+
 //
 // P_UnsetThingPosition
 // Unlinks a thing from block map and sectors.
@@ -283,8 +399,9 @@ void P_LineOpening(line_t *linedef) {
 // these structures need to be updated.
 //
 void P_UnsetThingPosition(mobj_t *thing) {
-    int blockx;
-    int blocky;
+    blockthings_t *block;
+    mobj_t *other;
+    int i;
 
     if (!(thing->flags & MF_NOSECTOR)) {
         // inert things don't need to be in blockmap?
@@ -298,23 +415,30 @@ void P_UnsetThingPosition(mobj_t *thing) {
             thing->subsector->sector->thinglist = thing->snext;
     }
 
-    if (!(thing->flags & MF_NOBLOCKMAP)) {
+    if (!(thing->flags & MF_NOBLOCKMAP) && thing->blocknum >= 0) {
         // inert things don't need to be in blockmap
         // unlink from block map
-        if (thing->bnext)
-            thing->bnext->bprev = thing->bprev;
-
-        if (thing->bprev)
-            thing->bprev->bnext = thing->bnext;
-        else {
-            blockx = (thing->x - bmaporgx) >> MAPBLOCKSHIFT;
-            blocky = (thing->y - bmaporgy) >> MAPBLOCKSHIFT;
-
-            if (blockx >= 0 && blockx < bmapwidth && blocky >= 0 && blocky < bmapheight) {
-                blocklinks[blocky * bmapwidth + blockx] = thing->bnext;
+        block = &blockthings[thing->blocknum];
+        block->count--;
+
+        if (unorderedblocks) {
+            // move the last thing into the gap
+            other = block->things[block->count];
+            block->things[thing->blockindex] = other;
+            other->blockindex = thing->blockindex;
+        } else {
+            // close the gap, keeping the order
+            for (i = thing->blockindex; i < block->count; i++) {
+                block->things[i] = block->things[i + 1];
+                block->things[i]->blockindex = i;
             }
         }
+
+        thing->blocknum = -1;
     }
+
+    if (thing->touchnodes)
+        P_UnlinkTouchNodes(thing);
 }
 
 //
@@ -328,7 +452,8 @@ void P_SetThingPosition(mobj_t *thing) {
     sector_t *sec;
     int blockx;
     int blocky;
-    mobj_t **link;
+    blockthings_t *block;
+    mobj_t **things;
 
     // link into subsector
     ss = R_PointInSubsector(thing->x, thing->y);
@@ -354,18 +479,32 @@ void P_SetThingPosition(mobj_t *thing) {
         blocky = (thing->y - bmaporgy) >> MAPBLOCKSHIFT;
 
         if (blockx >= 0 && blockx < bmapwidth && blocky >= 0 && blocky < bmapheight) {
-            link = &blocklinks[blocky * bmapwidth + blockx];
-            thing->bprev = NULL;
-            thing->bnext = *link;
-            if (*link)
-                (*link)->bprev = thing;
+            thing->blocknum = blocky * bmapwidth + blockx;
+            block = &blockthings[thing->blocknum];
+
+            if (block->count == block->size) {
+                block->size = block->size ? block->size * 2 : 4;
+                things = Z_Malloc(block->size * sizeof(*things), PU_LEVEL, 0);
+
+                if (block->count) {
+                    memcpy(things, block->things, block->count * sizeof(*things));
+                    Z_Free(block->things);
+                }
+
+                block->things = things;
+            }
+
+            thing->blockindex = block->count;
+            block->things[block->count++] = thing;
 
-            *link = thing;
+            if (sectortouchlists)
+                P_LinkTouchNodes(thing);
         } else {
             // thing is off the map
-            thing->bnext = thing->bprev = NULL;
+            thing->blocknum = -1;
         }
-    }
+    } else
+        thing->blocknum = -1;
 }
 
 //
@@ -415,15 +554,43 @@ boolean P_BlockLinesIterator(int x, int y, boolean (*func)(line_t *)) {
 // P_BlockThingsIterator
 //
 boolean P_BlockThingsIterator(int x, int y, boolean (*func)(mobj_t *)) {
+    blockthings_t *block;
     mobj_t *mobj;
+    mobj_t *next;
+    int blocknum;
+    int i;
 
     if (x < 0 || y < 0 || x >= bmapwidth || y >= bmapheight) {
         return true;
     }
 
-    for (mobj = blocklinks[y * bmapwidth + x]; mobj; mobj = mobj->bnext) {
+    blocknum = y * bmapwidth + x;
+    block = &blockthings[blocknum];
+
+    // Newest first, the order vanilla's block chains are walked in.
+    for (i = block->count - 1; i >= 0; i--) {
+        mobj = block->things[i];
+        next = i > 0 ? block->things[i - 1] : NULL;
+
         if (!func(mobj))
             return false;
+
+        if (next == NULL)
+            break;
+
+        // The function may have unlinked things from this block, which
+        //  only ever moves the things left in it down, and links go on
+        //  top.  Carry on with the next older thing wherever it is now,
+        //  or below this one if that was unlinked.  If both were, the
+        //  older things are still below where the next one was.
+        if (next->blocknum == blocknum && next->blockindex < i)
+            i = next->blockindex + 1;
+        else if (mobj->blocknum == blocknum && mobj->blockindex <= i)
+            i = mobj->blockindex;
+        else if (i - 1 < block->count)
+            i = i - 1;
+        else
+            i = block->count;
     }
     return true;
 }
@@ -431,15 +598,58 @@ boolean P_BlockThingsIterator(int x, int y, boolean (*func)(mobj_t *)) {
 //
 // INTERCEPT ROUTINES
 //
-intercept_t intercepts[MAXINTERCEPTS];
+intercept_t *intercepts;
 intercept_t *intercept_p;
 
+// Room in intercepts[], and the merge sort's scratch space.
+static int maxintercepts;
+static intercept_t *interceptscratch;
+
+// Emulate vanilla's writes past the end of its 128 intercepts.
+static boolean interceptsoverrun;
+
 divline_t trace;
 boolean earlyout;
 int ptflags;
 
 static void InterceptsOverrun(int num_intercepts, intercept_t *intercept);
 
+//
+// P_InitIntercepts
+//
+void P_InitIntercepts(void) {
+    //!
+    // @category compat
+    //
+    // Emulate the memory overwrites of vanilla's intercepts table
+    // when a trace crosses more than 128 lines and things.  Some
+    // demos need this to stay in sync.
+    //
+
+    interceptsoverrun = M_ParmExists("-interceptsoverrun");
+
+    maxintercepts = MAXINTERCEPTS;
+    intercepts = I_Realloc(NULL, maxintercepts * sizeof(*intercepts));
+    interceptscratch = I_Realloc(NULL, maxintercepts * sizeof(*interceptscratch));
+}
+
+//
+// P_CheckIntercepts
+// Makes room for one more intercept at intercept_p.
+//
+static void P_CheckIntercepts(void) {
+    int count;
+
+    count = intercept_p - intercepts;
+
+    if (count == maxintercepts) {
+        maxintercepts *= 2;
+        intercepts = I_Realloc(intercepts, maxintercepts * sizeof(*intercepts));
+        interceptscratch = I_Realloc(interceptscratch, maxintercepts * sizeof(*interceptscratch));
+        intercept_p = intercepts + count;
+    }
+}
+
 //
 // PIT_AddLineIntercepts.
 // Looks for lines in the given block
@@ -481,10 +691,14 @@ boolean PIT_AddLineIntercepts(line_t *ld) {
         return false; // stop checking
     }
 
+    P_CheckIntercepts();
     intercept_p->frac = frac;
     intercept_p->isaline = true;
     intercept_p->d.line = ld;
-    InterceptsOverrun(intercept_p - intercepts, intercept_p);
+
+    if (interceptsoverrun)
+        InterceptsOverrun(intercept_p - intercepts, intercept_p);
+
     intercept_p++;
 
     return true; // continue
@@ -541,15 +755,71 @@ boolean PIT_AddThingIntercepts(mobj_t *thing) {
     if (frac < 0)
         return true; // behind source
 
+    P_CheckIntercepts();
     intercept_p->frac = frac;
     intercept_p->isaline = false;
     intercept_p->d.thing = thing;
-    InterceptsOverrun(intercept_p - intercepts, intercept_p);
+
+    if (interceptsoverrun)
+        InterceptsOverrun(intercept_p - intercepts, intercept_p);
+
     intercept_p++;
 
     return true; // keep going
 }
 
+//
+// P_SortIntercepts
+// Stable merge sort on frac.  Intercepts at the same distance stay
+//  in the order they were added, which is the one vanilla's repeated
+//  search for the closest intercept picked them in.
+//
+static intercept_t *P_SortIntercepts(int count) {
+    int width;
+    int lo;
+    int mid;
+    int hi;
+    int i;
+    int j;
+    int k;
+    intercept_t *sorted;
+    intercept_t *merged;
+    intercept_t *swap;
+
+    sorted = intercepts;
+    merged = interceptscratch;
+
+    for (width = 1; width < count; width *= 2) {
+        for (lo = 0; lo < count; lo += 2 * width) {
+            mid = lo + width < count ? lo + width : count;
+            hi = lo + 2 * width < count ? lo + 2 * width : count;
+
+            i = lo;
+            j = mid;
+            k = lo;
+
+            while (i < mid && j < hi) {
+                if (sorted[j].frac < sorted[i].frac)
+                    merged[k++] = sorted[j++];
+                else
+                    merged[k++] = sorted[i++];
+            }
+
+            while (i < mid)
+                merged[k++] = sorted[i++];
+
+            while (j < hi)
+                merged[k++] = sorted[j++];
+        }
+
+        swap = sorted;
+        sorted = merged;
+        merged = swap;
+    }
+
+    return sorted;
+}
+
 //
 // P_TraverseIntercepts
 // Returns true if the traverser function returns true
@@ -557,42 +827,18 @@ boolean PIT_AddThingIntercepts(mobj_t *thing) {
 //
 boolean P_TraverseIntercepts(traverser_t func, fixed_t maxfrac) {
     int count;
-    fixed_t dist;
-    intercept_t *scan;
-    intercept_t *in;
+    int i;
+    intercept_t *sorted;
 
     count = intercept_p - intercepts;
+    sorted = P_SortIntercepts(count);
 
-    in = 0; // shut up compiler warning
-
-    while (count--) {
-        dist = INT_MAX;
-        for (scan = intercepts; scan < intercept_p; scan++) {
-            if (scan->frac < dist) {
-                dist = scan->frac;
-                in = scan;
-            }
-        }
-
-        if (dist > maxfrac)
+    for (i = 0; i < count; i++) {
+        if (sorted[i].frac > maxfrac)
             return true; // checked everything in range
 
-#if 0 // UNUSED
-    {
-	// don't check these yet, there may be others inserted
-	in = scan = intercepts;
-	for ( scan = intercepts ; scan<intercept_p ; scan++)
-	    if (scan->frac > maxfrac)
-		*in++ = *scan;
-	intercept_p = in;
-	return false;
-    }
-#endif
-
-        if (!func(in))
+        if (!func(&sorted[i]))
             return false; // don't bother going farther
-
-        in->frac = INT_MAX;
     }
 
     return true; // everything was traversed
@@ -294,8 +294,8 @@ void P_NightmareRespawn(mobj_t *mobj) {
     mobj_t *mo;
     mapthing_t *mthing;
 
-    x = mobj->spawnpoint.x << FRACBITS;
-    y = mobj->spawnpoint.y << FRACBITS;
+    x = MO_SPAWNPOINT(mobj).x << FRACBITS;
+    y = MO_SPAWNPOINT(mobj).y << FRACBITS;
 
     // somthing is occupying it's position?
     if (!P_CheckPosition(mobj, x, y))
@@ -315,7 +315,7 @@ void P_NightmareRespawn(mobj_t *mobj) {
     S_StartSound(mo, sfx_telept);
 
     // spawn the new monster
-    mthing = &mobj->spawnpoint;
+    mthing = &MO_SPAWNPOINT(mobj);
 
     // spawn it
     if (mobj->info->flags & MF_SPAWNCEILING)
@@ -325,7 +325,7 @@ void P_NightmareRespawn(mobj_t *mobj) {
 
     // inherit attributes from deceased one
     mo = P_SpawnMobj(x, y, z, mobj->type);
-    mo->spawnpoint = mobj->spawnpoint;
+    MO_SPAWNPOINT(mo) = MO_SPAWNPOINT(mobj);
     mo->angle = ANG45 * (mthing->angle / 45);
 
     if (mthing->options & MTF_AMBUSH)
@@ -397,8 +397,10 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type) {
     state_t *st;
     mobjinfo_t *info;
 
-    mobj = Z_Malloc(sizeof(*mobj), PU_LEVEL, NULL);
+    mobj = Z_PoolAlloc(&mobjpool);
     memset(mobj, 0, sizeof(*mobj));
+    mobj->cold = Z_PoolAlloc(&mobjcoldpool);
+    memset(mobj->cold, 0, sizeof(*mobj->cold));
     info = &mobjinfo[type];
 
     mobj->type = type;
@@ -413,7 +415,7 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type) {
     if (gameskill != sk_nightmare)
         mobj->reactiontime = info->reactiontime;
 
-    mobj->lastlook = P_Random() % MAXPLAYERS;
+    MO_LASTLOOK(mobj) = P_Random() % MAXPLAYERS;
     // do not set the state with P_SetMobjState,
     // because action routines can not be called yet
     st = &states[info->spawnstate];
@@ -436,6 +438,8 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type) {
     else
         mobj->z = z;
 
+    P_ResetInterpolation(mobj);
+
     mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
 
     P_AddThinker(&mobj->thinker);
@@ -443,6 +447,18 @@ mobj_t *P_SpawnMobj(fixed_t x, fixed_t y, fixed_t z, mobjtype_t type) {
     return mobj;
 }
 
+//
+// P_ResetInterpolation
+// Starts the tic with the thing where it is now,
+//  so that the renderer does not draw a jump as movement.
+//
+void P_ResetInterpolation(mobj_t *mobj) {
+    MO_OLDX(mobj) = mobj->x;
+    MO_OLDY(mobj) = mobj->y;
+    MO_OLDZ(mobj) = mobj->z;
+    MO_OLDANGLE(mobj) = mobj->angle;
+}
+
 //
 // P_RemoveMobj
 //
@@ -454,7 +470,7 @@ int iquetail;
 void P_RemoveMobj(mobj_t *mobj) {
     if ((mobj->flags & MF_SPECIAL) && !(mobj->flags & MF_DROPPED) && (mobj->type != MT_INV) &&
         (mobj->type != MT_INS)) {
-        itemrespawnque[iquehead] = mobj->spawnpoint;
+        itemrespawnque[iquehead] = MO_SPAWNPOINT(mobj);
         itemrespawntime[iquehead] = leveltime;
         iquehead = (iquehead + 1) & (ITEMQUESIZE - 1);
 
@@ -529,7 +545,7 @@ void P_RespawnSpecials(void) {
         z = ONFLOORZ;
 
     mo = P_SpawnMobj(x, y, z, i);
-    mo->spawnpoint = *mthing;
+    MO_SPAWNPOINT(mo) = *mthing;
     mo->angle = ANG45 * (mthing->angle / 45);
 
     // pull it from the que
@@ -587,6 +603,7 @@ void P_SpawnPlayer(mapthing_t *mthing) {
     p->extralight = 0;
     p->fixedcolormap = 0;
     p->viewheight = VIEWHEIGHT;
+    p->oldviewz = p->viewz;
 
     // setup gun psprite
     P_SetupPsprites(p);
@@ -685,7 +702,7 @@ void P_SpawnMapThing(mapthing_t *mthing) {
         z = ONFLOORZ;
 
     mobj = P_SpawnMobj(x, y, z, i);
-    mobj->spawnpoint = *mthing;
+    MO_SPAWNPOINT(mobj) = *mthing;
 
     if (mobj->tics > 0)
         mobj->tics = 1 + (P_Random() % mobj->tics);
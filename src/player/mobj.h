@@ -61,7 +61,7 @@
 // The sound code uses the x,y, and subsector fields
 // to do stereo positioning of any sound effited by the mobj_t.
 //
-// The play simulation uses the blocklinks, x,y,z, radius, height
+// The play simulation uses the block lists, x,y,z, radius, height
 // to determine when mobj_ts are touching each other,
 // touching lines in the map, or hit by trace lines (gunshots,
 // lines of sight, etc).
@@ -79,7 +79,7 @@
 // in the play world (block movement, be shot, etc) will also
 // need to be linked into the blockmap.
 // If the thing has the MF_NOBLOCK flag set, it will not use
-// the block links. It can still interact with other things,
+// the block lists. It can still interact with other things,
 // but only as the instigator (missiles will run into other
 // things, but nothing can run into a missile).
 // Each block in the grid is 128*128 units, and knows about
@@ -189,7 +189,41 @@ typedef enum {
 
 } mobjflag_t;
 
+// Fields that the movement, collision and thinker code hardly
+//  ever reads.  Kept out of line so that the hot part of mobj_t
+//  stays within the first cache lines; use the MO_ accessors.
+typedef struct {
+    // Player number last looked for.
+    int lastlook;
+
+    // For nightmare respawn.
+    mapthing_t spawnpoint;
+
+    // Thing being chased/attacked for tracers.
+    struct mobj_s *tracer;
+
+    // Position and angle at the start of the tic, for drawing
+    //  in between tics when the framerate is uncapped.
+    fixed_t oldx;
+    fixed_t oldy;
+    fixed_t oldz;
+    angle_t oldangle;
+
+} mobjcold_t;
+
+#define MO_LASTLOOK(mo) ((mo)->cold->lastlook)
+#define MO_SPAWNPOINT(mo) ((mo)->cold->spawnpoint)
+#define MO_TRACER(mo) ((mo)->cold->tracer)
+#define MO_OLDX(mo) ((mo)->cold->oldx)
+#define MO_OLDY(mo) ((mo)->cold->oldy)
+#define MO_OLDZ(mo) ((mo)->cold->oldz)
+#define MO_OLDANGLE(mo) ((mo)->cold->oldangle)
+
 // Map Object definition.
+// The fields are ordered by how often the blockmap walks and
+//  P_TryMove / PIT_CheckThing touch them: everything a collision
+//  check reads sits in the first 64 bytes.  x, y and z must stay
+//  right after the thinker, degenmobj_t relies on it.
 typedef struct mobj_s {
     // List: thinker links.
     thinker_t thinker;
@@ -199,25 +233,13 @@ typedef struct mobj_s {
     fixed_t y;
     fixed_t z;
 
-    // More list: links in sector (if needed)
-    struct mobj_s *snext;
-    struct mobj_s *sprev;
-
-    // More drawing info: to determine current sprite.
-    angle_t angle;      // orientation
-    spritenum_t sprite; // used to find patch_t and flip value
-    int frame;          // might be ORed with FF_FULLBRIGHT
+    int flags;
 
     // Interaction info, by BLOCKMAP.
-    // Links in blocks (if needed).
-    struct mobj_s *bnext;
-    struct mobj_s *bprev;
-
-    struct subsector_s *subsector;
-
-    // The closest interval over all contacted Sectors.
-    fixed_t floorz;
-    fixed_t ceilingz;
+    // Mapblock the thing is listed in (if needed),
+    //  and its place in that block's thing array.
+    int blocknum;
+    int blockindex;
 
     // For movement checking.
     fixed_t radius;
@@ -228,15 +250,36 @@ typedef struct mobj_s {
     fixed_t momy;
     fixed_t momz;
 
+    // The closest interval over all contacted Sectors.
+    fixed_t floorz;
+    fixed_t ceilingz;
+
     // If == validcount, already checked.
     int validcount;
 
+    // More list: links in sector (if needed)
+    struct mobj_s *snext;
+    struct mobj_s *sprev;
+
+    struct subsector_s *subsector;
+
+    // Sectors touched, for P_ChangeSector (if needed).
+    struct secnode_s *touchnodes;
+
+    // Additional info record for player avatars only.
+    // Only valid if type == MT_PLAYER
+    struct player_s *player;
+
     mobjtype_t type;
     mobjinfo_t *info; // &mobjinfo[mobj->type]
 
+    // More drawing info: to determine current sprite.
+    angle_t angle;      // orientation
+    spritenum_t sprite; // used to find patch_t and flip value
+    int frame;          // might be ORed with FF_FULLBRIGHT
+
     int tics; // state tic counter
     state_t *state;
-    int flags;
     int health;
 
     // Movement direction, movement generation (zig-zagging).
@@ -255,18 +298,8 @@ typedef struct mobj_s {
     // no matter what (even if shot)
     int threshold;
 
-    // Additional info record for player avatars only.
-    // Only valid if type == MT_PLAYER
-    struct player_s *player;
-
-    // Player number last looked for.
-    int lastlook;
-
-    // For nightmare respawn.
-    mapthing_t spawnpoint;
-
-    // Thing being chased/attacked for tracers.
-    struct mobj_s *tracer;
+    // Rarely used fields, allocated alongside from mobjcoldpool.
+    mobjcold_t *cold;
 
 } mobj_t;
 
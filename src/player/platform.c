@@ -34,7 +34,8 @@
 // Data.
 #include "../sound/sounds.h"
 
-plat_t *activeplats[MAXPLATS];
+plat_t *activeplats[TAGCHAINS];
+int numactiveplats;
 
 //
 // Move a plat up and down
@@ -133,7 +134,7 @@ int EV_DoPlat(line_t *line, plattype_e type, int amount) {
 
         // Find lowest & highest floors around sector
         rtn = 1;
-        plat = Z_Malloc(sizeof(*plat), PU_LEVSPEC, 0);
+        plat = Z_PoolAlloc(&platpool);
         P_AddThinker(&plat->thinker);
 
         plat->type = type;
@@ -216,47 +217,60 @@ int EV_DoPlat(line_t *line, plattype_e type, int amount) {
 }
 
 void P_ActivateInStasis(int tag) {
-    int i;
+    plat_t *plat;
 
-    for (i = 0; i < MAXPLATS; i++)
-        if (activeplats[i] && (activeplats[i])->tag == tag && (activeplats[i])->status == in_stasis) {
-            (activeplats[i])->status = (activeplats[i])->oldstatus;
-            (activeplats[i])->thinker.function.acp1 = (actionf_p1)T_PlatRaise;
+    for (plat = activeplats[TAGCHAIN(tag)]; plat != NULL; plat = plat->tagnext)
+        if (plat->tag == tag && plat->status == in_stasis) {
+            plat->status = plat->oldstatus;
+            plat->thinker.function.acp1 = (actionf_p1)T_PlatRaise;
         }
 }
 
 void EV_StopPlat(line_t *line) {
-    int j;
-
-    for (j = 0; j < MAXPLATS; j++)
-        if (activeplats[j] && ((activeplats[j])->status != in_stasis) &&
-            ((activeplats[j])->tag == line->tag)) {
-            (activeplats[j])->oldstatus = (activeplats[j])->status;
-            (activeplats[j])->status = in_stasis;
-            (activeplats[j])->thinker.function.acv = (actionf_v)NULL;
+    plat_t *plat;
+
+    for (plat = activeplats[TAGCHAIN(line->tag)]; plat != NULL; plat = plat->tagnext)
+        if (plat->status != in_stasis && plat->tag == line->tag) {
+            plat->oldstatus = plat->status;
+            plat->status = in_stasis;
+            plat->thinker.function.acv = (actionf_v)NULL;
         }
 }
 
 void P_AddActivePlat(plat_t *plat) {
-    int i;
+    plat_t **chain;
 
-    for (i = 0; i < MAXPLATS; i++)
-        if (activeplats[i] == NULL) {
-            activeplats[i] = plat;
-            return;
-        }
-    error("P_AddActivePlat: no more plats!");
+    if (speciallimits && numactiveplats == MAXPLATS)
+        error("P_AddActivePlat: no more plats!");
+
+    chain = &activeplats[TAGCHAIN(plat->tag)];
+
+    plat->tagprev = NULL;
+    plat->tagnext = *chain;
+
+    if (*chain)
+        (*chain)->tagprev = plat;
+
+    *chain = plat;
+    plat->active = true;
+    numactiveplats++;
 }
 
 void P_RemoveActivePlat(plat_t *plat) {
-    int i;
-    for (i = 0; i < MAXPLATS; i++)
-        if (plat == activeplats[i]) {
-            (activeplats[i])->sector->specialdata = NULL;
-            P_RemoveThinker(&(activeplats[i])->thinker);
-            activeplats[i] = NULL;
-
-            return;
-        }
-    error("P_RemoveActivePlat: can't find plat!");
+    if (!plat->active)
+        error("P_RemoveActivePlat: can't find plat!");
+
+    plat->sector->specialdata = NULL;
+    P_RemoveThinker(&plat->thinker);
+
+    if (plat->tagprev)
+        plat->tagprev->tagnext = plat->tagnext;
+    else
+        activeplats[TAGCHAIN(plat->tag)] = plat->tagnext;
+
+    if (plat->tagnext)
+        plat->tagnext->tagprev = plat->tagprev;
+
+    plat->active = false;
+    numactiveplats--;
 }
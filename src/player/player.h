@@ -75,6 +75,8 @@ typedef struct player_s {
     //  including viewpoint bobbing during movement.
     // Focal origin above r.z
     fixed_t viewz;
+    // viewz at the start of the tic, for interpolation.
+    fixed_t oldviewz;
     // Base height above floor for viewz.
     fixed_t viewheight;
     // Bob/squat speed.
@@ -293,10 +293,10 @@ static void saveg_read_mobj_t(mobj_t *str) {
     str->frame = saveg_read32();
 
     // struct mobj_s* bnext;
-    str->bnext = saveg_readp();
+    saveg_readp();
 
     // struct mobj_s* bprev;
-    str->bprev = saveg_readp();
+    saveg_readp();
 
     // struct subsector_s* subsector;
     str->subsector = saveg_readp();
@@ -369,13 +369,13 @@ static void saveg_read_mobj_t(mobj_t *str) {
     }
 
     // int lastlook;
-    str->lastlook = saveg_read32();
+    MO_LASTLOOK(str) = saveg_read32();
 
     // mapthing_t spawnpoint;
-    saveg_read_mapthing_t(&str->spawnpoint);
+    saveg_read_mapthing_t(&MO_SPAWNPOINT(str));
 
     // struct mobj_s* tracer;
-    str->tracer = saveg_readp();
+    MO_TRACER(str) = saveg_readp();
 }
 
 static void saveg_write_mobj_t(mobj_t *str) {
@@ -407,10 +407,10 @@ static void saveg_write_mobj_t(mobj_t *str) {
     saveg_write32(str->frame);
 
     // struct mobj_s* bnext;
-    saveg_writep(str->bnext);
+    saveg_writep(NULL);
 
     // struct mobj_s* bprev;
-    saveg_writep(str->bprev);
+    saveg_writep(NULL);
 
     // struct subsector_s* subsector;
     saveg_writep(str->subsector);
@@ -480,13 +480,13 @@ static void saveg_write_mobj_t(mobj_t *str) {
     }
 
     // int lastlook;
-    saveg_write32(str->lastlook);
+    saveg_write32(MO_LASTLOOK(str));
 
     // mapthing_t spawnpoint;
-    saveg_write_mapthing_t(&str->spawnpoint);
+    saveg_write_mapthing_t(&MO_SPAWNPOINT(str));
 
     // struct mobj_s* tracer;
-    saveg_writep(str->tracer);
+    saveg_writep(MO_TRACER(str));
 }
 
 //
@@ -1372,6 +1372,8 @@ void P_UnArchivePlayers(void) {
 
         saveg_reaplayer_t(&players[i]);
 
+        players[i].oldviewz = players[i].viewz;
+
         // will be set when unarc thinker
         players[i].mo = NULL;
         players[i].message = NULL;
@@ -1430,10 +1432,14 @@ void P_UnArchiveWorld(void) {
     line_t *li;
     side_t *si;
 
+    P_InvalidateSightCache();
+
     // do sectors
     for (i = 0, sec = sectors; i < numsectors; i++, sec++) {
         sec->floorheight = saveg_read16() << FRACBITS;
         sec->ceilingheight = saveg_read16() << FRACBITS;
+        sec->oldfloorheight = sec->floorheight;
+        sec->oldceilingheight = sec->ceilingheight;
         sec->floorpic = saveg_read16();
         sec->ceilingpic = saveg_read16();
         sec->lightlevel = saveg_read16();
@@ -1510,7 +1516,7 @@ void P_UnArchiveThinkers(void) {
         if (currentthinker->function.acp1 == (actionf_p1)P_MobjThinker)
             P_RemoveMobj((mobj_t *)currentthinker);
         else
-            Z_Free(currentthinker);
+            Z_PoolFree(currentthinker);
 
         currentthinker = next;
     }
@@ -1525,16 +1531,20 @@ void P_UnArchiveThinkers(void) {
 
         case tc_mobj:
             saveg_read_pad();
-            mobj = Z_Malloc(sizeof(*mobj), PU_LEVEL, NULL);
+            mobj = Z_PoolAlloc(&mobjpool);
+            mobj->cold = Z_PoolAlloc(&mobjcoldpool);
+            memset(mobj->cold, 0, sizeof(*mobj->cold));
             saveg_read_mobj_t(mobj);
 
             mobj->target = NULL;
-            mobj->tracer = NULL;
+            MO_TRACER(mobj) = NULL;
+            mobj->touchnodes = NULL;
             P_SetThingPosition(mobj);
             mobj->info = &mobjinfo[mobj->type];
             mobj->floorz = mobj->subsector->sector->floorheight;
             mobj->ceilingz = mobj->subsector->sector->ceilingheight;
             mobj->thinker.function.acp1 = (actionf_p1)P_MobjThinker;
+            P_ResetInterpolation(mobj);
             P_AddThinker(&mobj->thinker);
             break;
 
@@ -1572,16 +1582,12 @@ enum {
 //
 void P_ArchiveSpecials(void) {
     thinker_t *th;
-    int i;
 
     // save off the current thinkers
     for (th = thinkercap.next; th != &thinkercap; th = th->next) {
         if (th->function.acv == (actionf_v)NULL) {
-            for (i = 0; i < MAXCEILINGS; i++)
-                if (activeceilings[i] == (ceiling_t *)th)
-                    break;
-
-            if (i < MAXCEILINGS) {
+            // Only ceilings in stasis on the active list are saved.
+            if (Z_PoolOf(th) == &ceilingpool && ((ceiling_t *)th)->active) {
                 saveg_write8(tc_ceiling);
                 saveg_write_pad();
                 saveg_write_ceiling_t((ceiling_t *)th);
@@ -1666,7 +1672,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_ceiling:
             saveg_read_pad();
-            ceiling = Z_Malloc(sizeof(*ceiling), PU_LEVEL, NULL);
+            ceiling = Z_PoolAlloc(&ceilingpool);
             saveg_read_ceiling_t(ceiling);
             ceiling->sector->specialdata = ceiling;
 
@@ -1679,7 +1685,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_door:
             saveg_read_pad();
-            door = Z_Malloc(sizeof(*door), PU_LEVEL, NULL);
+            door = Z_PoolAlloc(&doorpool);
             saveg_read_vldoor_t(door);
             door->sector->specialdata = door;
             door->thinker.function.acp1 = (actionf_p1)T_VerticalDoor;
@@ -1688,7 +1694,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_floor:
             saveg_read_pad();
-            floor = Z_Malloc(sizeof(*floor), PU_LEVEL, NULL);
+            floor = Z_PoolAlloc(&floorpool);
             saveg_read_floormove_t(floor);
             floor->sector->specialdata = floor;
             floor->thinker.function.acp1 = (actionf_p1)T_MoveFloor;
@@ -1697,7 +1703,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_plat:
             saveg_read_pad();
-            plat = Z_Malloc(sizeof(*plat), PU_LEVEL, NULL);
+            plat = Z_PoolAlloc(&platpool);
             saveg_read_plat_t(plat);
             plat->sector->specialdata = plat;
 
@@ -1710,7 +1716,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_flash:
             saveg_read_pad();
-            flash = Z_Malloc(sizeof(*flash), PU_LEVEL, NULL);
+            flash = Z_PoolAlloc(&lightflashpool);
             saveg_read_lightflash_t(flash);
             flash->thinker.function.acp1 = (actionf_p1)T_LightFlash;
             P_AddThinker(&flash->thinker);
@@ -1718,7 +1724,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_strobe:
             saveg_read_pad();
-            strobe = Z_Malloc(sizeof(*strobe), PU_LEVEL, NULL);
+            strobe = Z_PoolAlloc(&strobepool);
             saveg_read_strobe_t(strobe);
             strobe->thinker.function.acp1 = (actionf_p1)T_StrobeFlash;
             P_AddThinker(&strobe->thinker);
@@ -1726,7 +1732,7 @@ void P_UnArchiveSpecials(void) {
 
         case tc_glow:
             saveg_read_pad();
-            glow = Z_Malloc(sizeof(*glow), PU_LEVEL, NULL);
+            glow = Z_PoolAlloc(&glowpool);
             saveg_read_glow_t(glow);
             glow->thinker.function.acp1 = (actionf_p1)T_Glow;
             P_AddThinker(&glow->thinker);
@@ -20,6 +20,7 @@
 #include <math.h>
 #include <stdlib.h>
 
+#include "../mem/arena.h"
 #include "../mem/zone.h"
 
 #include "../impl/swap.h"
@@ -33,6 +34,7 @@
 
 #include "../game/def.h"
 #include "local.h"
+#include "setup.h"
 
 #include "../sound/sound.h"
 
@@ -83,8 +85,12 @@ short *blockmaplump;
 // origin of block map
 fixed_t bmaporgx;
 fixed_t bmaporgy;
-// for thing chains
-mobj_t **blocklinks;
+// for thing lists
+blockthings_t *blockthings;
+// allow swap removal from the thing lists
+boolean unorderedblocks;
+// keep the sector touch lists for P_ChangeSector
+boolean sectortouchlists;
 
 // REJECT
 // For fast sight rejection.
@@ -95,6 +101,11 @@ mobj_t **blocklinks;
 //
 byte *rejectmatrix;
 
+arena_t levelarena;
+
+// Default arena block size, for anything past the reserved estimate.
+#define LEVELARENA_SIZE (1024 * 1024)
+
 // Maintain single and multi player starting spots.
 #define MAX_DEATHMATCH_STARTS 10
 
@@ -116,8 +127,8 @@ void P_LoadVertexes(int lump) {
     //  total lump length / vertex record length.
     numvertexes = W_LumpLength(lump) / sizeof(mapvertex_t);
 
-    // Allocate zone memory for buffer.
-    vertexes = Z_Malloc(numvertexes * sizeof(vertex_t), PU_LEVEL, 0);
+    // Allocate memory for buffer.
+    vertexes = Z_ArenaAlloc(&levelarena, numvertexes * sizeof(vertex_t));
 
     // Load data into cache.
     data = W_CacheLumpNum(lump, PU_STATIC);
@@ -167,7 +178,7 @@ void P_LoadSegs(int lump) {
     int sidenum;
 
     numsegs = W_LumpLength(lump) / sizeof(mapseg_t);
-    segs = Z_Malloc(numsegs * sizeof(seg_t), PU_LEVEL, 0);
+    segs = Z_ArenaAlloc(&levelarena, numsegs * sizeof(seg_t));
     memset(segs, 0, numsegs * sizeof(seg_t));
     data = W_CacheLumpNum(lump, PU_STATIC);
 
@@ -226,7 +237,7 @@ void P_LoadSubsectors(int lump) {
     subsector_t *ss;
 
     numsubsectors = W_LumpLength(lump) / sizeof(mapsubsector_t);
-    subsectors = Z_Malloc(numsubsectors * sizeof(subsector_t), PU_LEVEL, 0);
+    subsectors = Z_ArenaAlloc(&levelarena, numsubsectors * sizeof(subsector_t));
     data = W_CacheLumpNum(lump, PU_STATIC);
 
     ms = (mapsubsector_t *)data;
@@ -251,7 +262,7 @@ void P_LoadSectors(int lump) {
     sector_t *ss;
 
     numsectors = W_LumpLength(lump) / sizeof(mapsector_t);
-    sectors = Z_Malloc(numsectors * sizeof(sector_t), PU_LEVEL, 0);
+    sectors = Z_ArenaAlloc(&levelarena, numsectors * sizeof(sector_t));
     memset(sectors, 0, numsectors * sizeof(sector_t));
     data = W_CacheLumpNum(lump, PU_STATIC);
 
@@ -260,6 +271,8 @@ void P_LoadSectors(int lump) {
     for (i = 0; i < numsectors; i++, ss++, ms++) {
         ss->floorheight = SHORT(ms->floorheight) << FRACBITS;
         ss->ceilingheight = SHORT(ms->ceilingheight) << FRACBITS;
+        ss->oldfloorheight = ss->floorheight;
+        ss->oldceilingheight = ss->ceilingheight;
         ss->floorpic = R_FlatNumForName(ms->floorpic);
         ss->ceilingpic = R_FlatNumForName(ms->ceilingpic);
         ss->lightlevel = SHORT(ms->lightlevel);
@@ -283,7 +296,7 @@ void P_LoadNodes(int lump) {
     node_t *no;
 
     numnodes = W_LumpLength(lump) / sizeof(mapnode_t);
-    nodes = Z_Malloc(numnodes * sizeof(node_t), PU_LEVEL, 0);
+    nodes = Z_ArenaAlloc(&levelarena, numnodes * sizeof(node_t));
     data = W_CacheLumpNum(lump, PU_STATIC);
 
     mn = (mapnode_t *)data;
@@ -377,7 +390,7 @@ void P_LoadLineDefs(int lump) {
     vertex_t *v2;
 
     numlines = W_LumpLength(lump) / sizeof(maplinedef_t);
-    lines = Z_Malloc(numlines * sizeof(line_t), PU_LEVEL, 0);
+    lines = Z_ArenaAlloc(&levelarena, numlines * sizeof(line_t));
     memset(lines, 0, numlines * sizeof(line_t));
     data = W_CacheLumpNum(lump, PU_STATIC);
 
@@ -446,7 +459,7 @@ void P_LoadSideDefs(int lump) {
     side_t *sd;
 
     numsides = W_LumpLength(lump) / sizeof(mapsidedef_t);
-    sides = Z_Malloc(numsides * sizeof(side_t), PU_LEVEL, 0);
+    sides = Z_ArenaAlloc(&levelarena, numsides * sizeof(side_t));
     memset(sides, 0, numsides * sizeof(side_t));
     data = W_CacheLumpNum(lump, PU_STATIC);
 
@@ -475,7 +488,7 @@ void P_LoadBlockMap(int lump) {
     lumplen = W_LumpLength(lump);
     count = lumplen / 2;
 
-    blockmaplump = Z_Malloc(lumplen, PU_LEVEL, NULL);
+    blockmaplump = Z_ArenaAlloc(&levelarena, lumplen);
     W_ReadLump(lump, blockmaplump);
     blockmap = blockmaplump + 4;
 
@@ -492,20 +505,35 @@ void P_LoadBlockMap(int lump) {
     bmapwidth = blockmaplump[2];
     bmapheight = blockmaplump[3];
 
-    // Clear out mobj chains
+    // Clear out mobj lists
+
+    count = sizeof(*blockthings) * bmapwidth * bmapheight;
+    blockthings = Z_ArenaAlloc(&levelarena, count);
+    memset(blockthings, 0, count);
 
-    count = sizeof(*blocklinks) * bmapwidth * bmapheight;
-    blocklinks = Z_Malloc(count, PU_LEVEL, 0);
-    memset(blocklinks, 0, count);
+    //!
+    // @category compat
+    //
+    // Remove things from the blockmap by swapping the last thing in
+    // the block into the gap.  Faster in crowded maps, but changes
+    // the order in which things are checked against each other, so
+    // it is ignored for demos and netgames.
+    //
+
+    unorderedblocks = M_ParmExists("-unorderedblocks") && !demoplayback && !demorecording && !netgame;
 }
 
 //
 // P_GroupLines
-// Builds sector line lists and subsector sector numbers.
+// Builds sector line lists, adjacency lists and subsector sector numbers.
 // Finds block bounding boxes for sectors.
 //
 void P_GroupLines(void) {
     line_t **linebuffer;
+    sectoradj_t *adjbuffer;
+    sectoradj_t *adj;
+    sector_t *other;
+    int totaladjacent;
     int i;
     int j;
     line_t *li;
@@ -536,7 +564,7 @@ void P_GroupLines(void) {
     }
 
     // build line tables for each sector
-    linebuffer = Z_Malloc(totallines * sizeof(line_t *), PU_LEVEL, 0);
+    linebuffer = Z_ArenaAlloc(&levelarena, totallines * sizeof(line_t *));
 
     for (i = 0; i < numsectors; ++i) {
         // Assign the line buffer for this sector
@@ -570,6 +598,41 @@ void P_GroupLines(void) {
         }
     }
 
+    // Build the adjacency lists: the two-sided lines of each
+    //  sector, in line order, with the sector across each one.
+
+    totaladjacent = 0;
+    sector = sectors;
+    for (i = 0; i < numsectors; i++, sector++) {
+        for (j = 0; j < sector->linecount; j++) {
+            if (getNextSector(sector->lines[j], sector) != NULL)
+                totaladjacent++;
+        }
+    }
+
+    adjbuffer = Z_ArenaAlloc(&levelarena, totaladjacent * sizeof(sectoradj_t));
+
+    sector = sectors;
+    for (i = 0; i < numsectors; i++, sector++) {
+        sector->adjacent = adjbuffer;
+        sector->adjacentcount = 0;
+
+        for (j = 0; j < sector->linecount; j++) {
+            li = sector->lines[j];
+            other = getNextSector(li, sector);
+
+            if (other == NULL)
+                continue;
+
+            adj = &sector->adjacent[sector->adjacentcount++];
+            adj->sector = other;
+            adj->line = li;
+            adj->soundblock = (li->flags & ML_SOUNDBLOCK) != 0;
+        }
+
+        adjbuffer += sector->adjacentcount;
+    }
+
     // Generate bounding boxes for sectors
 
     sector = sectors;
@@ -670,15 +733,55 @@ static void P_LoadReject(int lumpnum) {
     lumplen = W_LumpLength(lumpnum);
 
     if (lumplen >= minlength) {
-        rejectmatrix = W_CacheLumpNum(lumpnum, PU_LEVEL);
+        rejectmatrix = Z_ArenaAlloc(&levelarena, lumplen);
+        W_ReadLump(lumpnum, rejectmatrix);
     } else {
-        rejectmatrix = Z_Malloc(minlength, PU_LEVEL, &rejectmatrix);
+        rejectmatrix = Z_ArenaAlloc(&levelarena, minlength);
         W_ReadLump(lumpnum, rejectmatrix);
 
         PadRejectArray(rejectmatrix + lumplen, minlength - lumplen);
     }
 }
 
+//
+// P_LevelArenaSize
+// Estimates from the lump lengths how much of the level arena a map
+//  needs, so that its data can be loaded into one block.
+//
+static size_t P_LevelArenaSize(int lumpnum) {
+    size_t numlines, numsectors, numblocks;
+    size_t reject, size;
+
+    numlines = W_LumpLength(lumpnum + ML_LINEDEFS) / sizeof(maplinedef_t);
+    numsectors = W_LumpLength(lumpnum + ML_SECTORS) / sizeof(mapsector_t);
+
+    // the blockmap has an offset for each block after its header
+    numblocks = W_LumpLength(lumpnum + ML_BLOCKMAP) / 2;
+
+    reject = W_LumpLength(lumpnum + ML_REJECT);
+
+    if (reject < (numsectors * numsectors + 7) / 8)
+        reject = (numsectors * numsectors + 7) / 8;
+
+    size = W_LumpLength(lumpnum + ML_VERTEXES) / sizeof(mapvertex_t) * sizeof(vertex_t);
+    size += W_LumpLength(lumpnum + ML_SEGS) / sizeof(mapseg_t) * sizeof(seg_t);
+    size += W_LumpLength(lumpnum + ML_SSECTORS) / sizeof(mapsubsector_t) * sizeof(subsector_t);
+    size += W_LumpLength(lumpnum + ML_NODES) / sizeof(mapnode_t) * sizeof(node_t);
+    size += W_LumpLength(lumpnum + ML_SIDEDEFS) / sizeof(mapsidedef_t) * sizeof(side_t);
+    size += numsectors * (sizeof(sector_t) + sizeof(int));
+    size += numlines * sizeof(line_t);
+    size += W_LumpLength(lumpnum + ML_BLOCKMAP) + numblocks * sizeof(blockthings_t);
+    size += reject;
+
+    // Both sides of every line in the line and adjacency lists, and
+    //  four 64 unit point grid cells per 128 unit block.
+    size += numlines * 2 * (sizeof(line_t *) + sizeof(sectoradj_t));
+    size += numblocks * 4 * sizeof(unsigned short);
+
+    // rounding of each allocation
+    return size + 16 * 16;
+}
+
 // pointer to the current map lump info struct
 lumpinfo_t *maplumpinfo;
 
@@ -703,7 +806,12 @@ void P_SetupLevel(int episode, int map) {
     // Make sure all sounds are stopped before Z_FreeTags.
     S_Start();
 
+    // Report on the zone as the last level left it.
+    if (maplumpinfo != NULL)
+        Z_EndLevelStats(maplumpinfo->name);
+
     Z_FreeTags(PU_LEVEL, PU_PURGELEVEL - 1);
+    Z_ResetArena(&levelarena);
 
     // UNUSED W_Profile ();
     P_InitThinkers();
@@ -721,6 +829,8 @@ void P_SetupLevel(int episode, int map) {
 
     maplumpinfo = lumpinfo[lumpnum];
 
+    Z_ReserveArena(&levelarena, P_LevelArenaSize(lumpnum));
+
     leveltime = 0;
 
     // note: most of this ordering is important
@@ -733,10 +843,17 @@ void P_SetupLevel(int episode, int map) {
     P_LoadSubsectors(lumpnum + ML_SSECTORS);
     P_LoadNodes(lumpnum + ML_NODES);
     P_LoadSegs(lumpnum + ML_SEGS);
+    R_InitPointGrid();
 
     P_GroupLines();
+    P_InitTagLists();
+    P_InvalidateSightCache();
     P_LoadReject(lumpnum + ML_REJECT);
 
+    // Vanilla re-checks every thing in a moving sector's blockbox,
+    //  even ones already stuck elsewhere; demos and netgames need it.
+    sectortouchlists = !demoplayback && !demorecording && !netgame;
+
     bodyqueslot = 0;
     deathmatch_p = deathmatchstarts;
     P_LoadThings(lumpnum + ML_THINGS);
@@ -759,6 +876,10 @@ void P_SetupLevel(int episode, int map) {
     // build subsector connect matrix
     //	UNUSED P_ConnectSubsectors ();
 
+    // Built whether or not the level is precached, so that
+    //  demo playback does not stall on composite textures.
+    R_InitTextureAtlas();
+
     // preload graphics
     if (precache)
         R_PrecacheLevel();
@@ -770,6 +891,10 @@ void P_SetupLevel(int episode, int map) {
 // P_Init
 //
 void P_Init(void) {
+    Z_InitArena(&levelarena, LEVELARENA_SIZE);
+    P_InitThinkerPools();
+    P_InitSight();
+    P_InitIntercepts();
     P_InitSwitchList();
     P_InitPicAnims();
     R_InitSprites(sprnames);
@@ -19,10 +19,14 @@
 #ifndef __P_SETUP__
 #define __P_SETUP__
 
+#include "../mem/arena.h"
 #include "../wad/wad.h"
 
 extern lumpinfo_t *maplumpinfo;
 
+// Level data, all thrown away at once when the next level starts.
+extern arena_t levelarena;
+
 // NOT called by W_Ticker. Fixme.
 void P_SetupLevel(int episode, int map);
 
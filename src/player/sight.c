@@ -16,10 +16,14 @@
 //	LineOfSight/Visibility checks, uses REJECT Lookup Table.
 //
 
+#include <stdint.h>
+#include <stdio.h>
+
 #include "../game/def.h"
 #include "../game/stat.h"
 
 #include "../impl/system.h"
+#include "../impl/timer.h"
 #include "local.h"
 
 // State.
@@ -38,6 +42,109 @@ fixed_t t2y;
 
 int sightcounts[2];
 
+//
+// Sight cache.
+// The answer only depends on where both things are, how tall they
+//  are and on the heights of the sectors whose lines the trace
+//  crossed.  Results are kept keyed on the positions and on the
+//  versions of those sectors, so a moving plane only drops the
+//  entries that looked across it.
+// Queries are not batched per tic: every caller acts on the answer
+//  (and calls P_Random) before the next thing thinks, so they have
+//  to be answered in order.  Entries live across tics instead.
+//
+#define SIGHTCACHESIZE 1024
+#define SIGHTSECTORS 16
+
+typedef struct {
+    int epoch;
+    mobj_t *t1;
+    mobj_t *t2;
+    fixed_t x1, y1, z1, height1;
+    fixed_t x2, y2, z2, height2;
+    boolean result;
+    int numsectors;
+    sector_t *sectors[SIGHTSECTORS];
+    int versions[SIGHTSECTORS];
+} sightentry_t;
+
+static sightentry_t sightcache[SIGHTCACHESIZE];
+
+// Bumped by P_InvalidateSightCache; entries from older epochs miss.
+static int sightepoch = 1;
+
+// The entry being traced, which P_SightSector adds sectors to.
+static sightentry_t *sightentry;
+
+static int sightcalls;
+static int sightcachehits;
+static uint64_t sighttime;
+
+//
+// P_InvalidateSightCache
+// Called when a level is set up or restored, where sector
+//  versions start over.
+//
+void P_InvalidateSightCache(void) { sightepoch++; }
+
+static void P_PrintSightStats(void) {
+    if (!sightcalls)
+        return;
+
+    printf("P_SightStats: %i checks, %i cached (%.1f%%), %i rejected, %i traced, %.3f ms tracing\n", sightcalls,
+           sightcachehits, sightcachehits * 100.0 / sightcalls, sightcounts[0], sightcounts[1],
+           sighttime / 1000.0);
+}
+
+//
+// P_InitSight
+//
+void P_InitSight(void) {
+    if (devparm)
+        I_AtExit(P_PrintSightStats, false);
+}
+
+//
+// P_SightSector
+// Notes that the trace depends on the heights of sec.
+// A trace across too many sectors is not cached.
+//
+static void P_SightSector(sector_t *sec) {
+    int i;
+
+    if (sightentry->epoch != sightepoch)
+        return;
+
+    for (i = 0; i < sightentry->numsectors; i++) {
+        if (sightentry->sectors[i] == sec)
+            return;
+    }
+
+    if (sightentry->numsectors == SIGHTSECTORS) {
+        sightentry->epoch = 0;
+        return;
+    }
+
+    sightentry->sectors[i] = sec;
+    sightentry->versions[i] = sec->version;
+    sightentry->numsectors++;
+}
+
+//
+// P_SightCached
+// Returns true if no sector the entry was traced across has moved.
+//
+static boolean P_SightCached(sightentry_t *entry) {
+    int i;
+
+    for (i = 0; i < entry->numsectors; i++) {
+        if (entry->sectors[i]->version != entry->versions[i])
+            return false;
+    }
+
+    return true;
+}
+
 //
 // P_DivlineSide
 // Returns side 0 (front), 1 (back), or 2 (on).
@@ -183,6 +290,9 @@ boolean P_CrossSubsector(int num) {
         front = seg->frontsector;
         back = seg->backsector;
 
+        P_SightSector(front);
+        P_SightSector(back);
+
         // no wall to block sight with?
         if (front->floorheight == back->floorheight && front->ceilingheight == back->ceilingheight)
             continue;
@@ -269,12 +379,17 @@ boolean P_CrossBSPNode(int bspnum) {
 // Uses REJECT.
 //
 boolean P_CheckSight(mobj_t *t1, mobj_t *t2) {
+    sightentry_t *entry;
+    uint64_t start;
+    uintptr_t hash;
     int s1;
     int s2;
     int pnum;
     int bytenum;
     int bitnum;
 
+    sightcalls++;
+
     // First check for trivial rejection.
 
     // Determine subsector entries in REJECT table.
@@ -292,6 +407,31 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2) {
         return false;
     }
 
+    // Then for the same question asked before.
+    hash = ((uintptr_t)t1 >> 4) * 0x9e3779b1u ^ ((uintptr_t)t2 >> 4);
+    entry = &sightcache[(hash ^ (hash >> 16)) & (SIGHTCACHESIZE - 1)];
+
+    if (entry->epoch == sightepoch && entry->t1 == t1 && entry->t2 == t2 && entry->x1 == t1->x &&
+        entry->y1 == t1->y && entry->z1 == t1->z && entry->height1 == t1->height && entry->x2 == t2->x &&
+        entry->y2 == t2->y && entry->z2 == t2->z && entry->height2 == t2->height && P_SightCached(entry)) {
+        sightcachehits++;
+        return entry->result;
+    }
+
+    entry->epoch = sightepoch;
+    entry->t1 = t1;
+    entry->t2 = t2;
+    entry->x1 = t1->x;
+    entry->y1 = t1->y;
+    entry->z1 = t1->z;
+    entry->height1 = t1->height;
+    entry->x2 = t2->x;
+    entry->y2 = t2->y;
+    entry->z2 = t2->z;
+    entry->height2 = t2->height;
+    entry->numsectors = 0;
+    sightentry = entry;
+
     // An unobstructed LOS is possible.
     // Now look from eyes of t1 to any part of t2.
     sightcounts[1]++;
@@ -310,5 +450,14 @@ boolean P_CheckSight(mobj_t *t1, mobj_t *t2) {
     strace.dy = t2->y - t1->y;
 
     // the head node is the last node output
-    return P_CrossBSPNode(numnodes - 1);
+    if (!devparm) {
+        entry->result = P_CrossBSPNode(numnodes - 1);
+        return entry->result;
+    }
+
+    start = I_GetTimeUS();
+    entry->result = P_CrossBSPNode(numnodes - 1);
+    sighttime += I_GetTimeUS() - start;
+
+    return entry->result;
 }
@@ -18,6 +18,7 @@
 //
 
 #include <stdio.h>
+#include <string.h>
 
 #include "../game/def.h"
 #include "../impl/system.h"
@@ -74,7 +75,12 @@ switchlist_t alphSwitchList[] = {
 
 int switchlist[MAXSWITCHES * 2];
 int numswitches;
-button_t buttonlist[MAXBUTTONS];
+
+button_t buttoncap;
+int numbuttons;
+boolean speciallimits;
+
+static pool_t buttonpool;
 
 //
 // P_InitSwitchList
@@ -106,34 +112,62 @@ void P_InitSwitchList(void) {
 
     numswitches = slindex / 2;
     switchlist[slindex] = -1;
+
+    Z_InitPool(&buttonpool, sizeof(button_t), MAXBUTTONS);
+}
+
+//
+// P_ClearButtons
+// Called at level start.
+//
+void P_ClearButtons(void) {
+    Z_ResetPool(&buttonpool);
+
+    memset(&buttoncap, 0, sizeof(buttoncap));
+    buttoncap.prev = buttoncap.next = &buttoncap;
+    numbuttons = 0;
+}
+
+//
+// P_RemoveButton
+//
+void P_RemoveButton(button_t *button) {
+    button->prev->next = button->next;
+    button->next->prev = button->prev;
+
+    Z_PoolFree(button);
+    numbuttons--;
 }
 
 //
 // Start a button counting down till it turns off.
 //
 void P_StartButton(line_t *line, bwhere_e w, int texture, int time) {
-    int i;
+    button_t *button;
 
     // See if button is already pressed
-    for (i = 0; i < MAXBUTTONS; i++) {
-        if (buttonlist[i].btimer && buttonlist[i].line == line) {
+    for (button = buttoncap.next; button != &buttoncap; button = button->next) {
+        if (button->line == line) {
 
             return;
         }
     }
 
-    for (i = 0; i < MAXBUTTONS; i++) {
-        if (!buttonlist[i].btimer) {
-            buttonlist[i].line = line;
-            buttonlist[i].where = w;
-            buttonlist[i].btexture = texture;
-            buttonlist[i].btimer = time;
-            buttonlist[i].soundorg = &line->frontsector->soundorg;
-            return;
-        }
-    }
-
-    error("P_StartButton: no button slots left!");
+    if (speciallimits && numbuttons == MAXBUTTONS)
+        error("P_StartButton: no button slots left!");
+
+    button = Z_PoolAlloc(&buttonpool);
+    button->line = line;
+    button->where = w;
+    button->btexture = texture;
+    button->btimer = time;
+    button->soundorg = &line->frontsector->soundorg;
+
+    button->prev = buttoncap.prev;
+    button->next = &buttoncap;
+    buttoncap.prev->next = button;
+    buttoncap.prev = button;
+    numbuttons++;
 }
 
 //
@@ -146,6 +180,7 @@ void P_ChangeSwitchTexture(line_t *line, int useAgain) {
     int texBot;
     int i;
     int sound;
+    degenmobj_t *soundorg;
 
     if (!useAgain)
         line->special = 0;
@@ -156,13 +191,20 @@ void P_ChangeSwitchTexture(line_t *line, int useAgain) {
 
     sound = sfx_swtchn;
 
+    // Vanilla plays switch sounds from buttonlist[0], the lowest slot,
+    // which a newer button takes over once it is free, and which has
+    // no origin while it is empty even if later slots are in use.
+    // The oldest active button is used here instead, or none; this
+    // only changes where the sound is heard, never the game state.
+    soundorg = buttoncap.next->soundorg;
+
     // EXIT SWITCH?
     if (line->special == 11)
         sound = sfx_swtchx;
 
     for (i = 0; i < numswitches * 2; i++) {
         if (switchlist[i] == texTop) {
-            S_StartSound(buttonlist->soundorg, sound);
+            S_StartSound(soundorg, sound);
             sides[line->sidenum[0]].toptexture = switchlist[i ^ 1];
 
             if (useAgain)
@@ -171,7 +213,7 @@ void P_ChangeSwitchTexture(line_t *line, int useAgain) {
             return;
         } else {
             if (switchlist[i] == texMid) {
-                S_StartSound(buttonlist->soundorg, sound);
+                S_StartSound(soundorg, sound);
                 sides[line->sidenum[0]].midtexture = switchlist[i ^ 1];
 
                 if (useAgain)
@@ -180,7 +222,7 @@ void P_ChangeSwitchTexture(line_t *line, int useAgain) {
                 return;
             } else {
                 if (switchlist[i] == texBot) {
-                    S_StartSound(buttonlist->soundorg, sound);
+                    S_StartSound(soundorg, sound);
                     sides[line->sidenum[0]].bottomtexture = switchlist[i ^ 1];
 
                     if (useAgain)
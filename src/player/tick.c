@@ -20,6 +20,7 @@
 #include "../mem/zone.h"
 #include "local.h"
 
+#include "../game/loop.h"
 #include "../game/stat.h"
 
 int leveltime;
@@ -35,10 +36,55 @@ int leveltime;
 // Both the head and tail of the thinker list.
 thinker_t thinkercap;
 
+// Thinkers of each kind are allocated from their own pool, so that
+//  the list mostly walks forwards through a few slabs of memory.
+pool_t mobjpool;
+pool_t mobjcoldpool;
+pool_t secnodepool;
+pool_t ceilingpool;
+pool_t doorpool;
+pool_t floorpool;
+pool_t platpool;
+pool_t fireflickerpool;
+pool_t lightflashpool;
+pool_t strobepool;
+pool_t glowpool;
+
+//
+// P_InitThinkerPools
+//
+void P_InitThinkerPools(void) {
+    Z_InitPool(&mobjpool, sizeof(mobj_t), 256);
+    Z_InitPool(&mobjcoldpool, sizeof(mobjcold_t), 256);
+    Z_InitPool(&secnodepool, sizeof(secnode_t), 256);
+    Z_InitPool(&ceilingpool, sizeof(ceiling_t), 64);
+    Z_InitPool(&doorpool, sizeof(vldoor_t), 64);
+    Z_InitPool(&floorpool, sizeof(floormove_t), 64);
+    Z_InitPool(&platpool, sizeof(plat_t), 64);
+    Z_InitPool(&fireflickerpool, sizeof(fireflicker_t), 64);
+    Z_InitPool(&lightflashpool, sizeof(lightflash_t), 64);
+    Z_InitPool(&strobepool, sizeof(strobe_t), 64);
+    Z_InitPool(&glowpool, sizeof(glow_t), 64);
+}
+
 //
 // P_InitThinkers
 //
-void P_InitThinkers(void) { thinkercap.prev = thinkercap.next = &thinkercap; }
+void P_InitThinkers(void) {
+    thinkercap.prev = thinkercap.next = &thinkercap;
+
+    Z_ResetPool(&mobjpool);
+    Z_ResetPool(&mobjcoldpool);
+    Z_ResetPool(&secnodepool);
+    Z_ResetPool(&ceilingpool);
+    Z_ResetPool(&doorpool);
+    Z_ResetPool(&floorpool);
+    Z_ResetPool(&platpool);
+    Z_ResetPool(&fireflickerpool);
+    Z_ResetPool(&lightflashpool);
+    Z_ResetPool(&strobepool);
+    Z_ResetPool(&glowpool);
+}
 
 //
 // P_AddThinker
@@ -74,7 +120,11 @@ void P_RunThinkers(void) {
             nextthinker = currentthinker->next;
             currentthinker->next->prev = currentthinker->prev;
             currentthinker->prev->next = currentthinker->next;
-            Z_Free(currentthinker);
+
+            if (Z_PoolOf(currentthinker) == &mobjpool)
+                Z_PoolFree(((mobj_t *)currentthinker)->cold);
+
+            Z_PoolFree(currentthinker);
         } else {
             if (currentthinker->function.acp1)
                 currentthinker->function.acp1(currentthinker);
@@ -84,6 +134,38 @@ void P_RunThinkers(void) {
     }
 }
 
+//
+// P_SaveInterpolation
+// Remembers where things and sector planes start the tic from,
+//  so that frames drawn before the next tic can be placed in between.
+//
+static void P_SaveInterpolation(void) {
+    thinker_t *th;
+    sector_t *sec;
+    int i;
+
+    for (th = thinkercap.next; th != &thinkercap; th = th->next) {
+        if (th->function.acp1 == (actionf_p1)P_MobjThinker)
+            P_ResetInterpolation((mobj_t *)th);
+    }
+
+    for (i = 0, sec = sectors; i < numsectors; i++, sec++) {
+        sec->oldfloorheight = sec->floorheight;
+        sec->oldceilingheight = sec->ceilingheight;
+    }
+
+    for (i = 0; i < MAXPLAYERS; i++) {
+        if (!playeringame[i] || !players[i].mo)
+            continue;
+
+        // viewz is only a placeholder until the first tic has run.
+        if (leveltime)
+            players[i].oldviewz = players[i].viewz;
+        else
+            players[i].oldviewz = players[i].mo->z + players[i].viewheight;
+    }
+}
+
 //
 // P_Ticker
 //
@@ -91,6 +173,11 @@ void P_RunThinkers(void) {
 void P_Ticker(void) {
     int i;
 
+    // Saved even when paused, so that a paused
+    //  game is not drawn moving.
+    if (uncapped)
+        P_SaveInterpolation();
+
     // run the tic
     if (paused)
         return;
@@ -32,21 +32,28 @@
 
 //#include "r_local.h"
 
-seg_t *curline;
-side_t *sidedef;
-line_t *linedef;
-sector_t *frontsector;
-sector_t *backsector;
-
-drawseg_t drawsegs[MAXDRAWSEGS];
-drawseg_t *ds_p;
+THREADLOCAL seg_t *curline;
+THREADLOCAL side_t *sidedef;
+THREADLOCAL line_t *linedef;
+THREADLOCAL sector_t *frontsector;
+THREADLOCAL sector_t *backsector;
+
+// Drawsegs live in the frame arena and move to a bigger
+//  block when they run out.
+THREADLOCAL drawseg_t *drawsegs;
+THREADLOCAL drawseg_t *ds_p;
+THREADLOCAL int maxdrawsegs;
 
 void R_StoreWallRange(int start, int stop);
 
 //
 // R_ClearDrawSegs
 //
-void R_ClearDrawSegs(void) { ds_p = drawsegs; }
+void R_ClearDrawSegs(void) {
+    maxdrawsegs = MAXDRAWSEGS;
+    drawsegs = Z_ArenaAlloc(&framearena, maxdrawsegs * sizeof(*drawsegs));
+    ds_p = drawsegs;
+}
 
 //
 // ClipWallSegment
@@ -69,8 +76,8 @@ typedef struct {
 #define MAXSEGS (SCREENWIDTH / 2 + 1)
 
 // newend is one past the last valid seg
-cliprange_t *newend;
-cliprange_t solidsegs[MAXSEGS];
+THREADLOCAL cliprange_t *newend;
+THREADLOCAL cliprange_t solidsegs[MAXSEGS];
 
 //
 // R_ClipSolidWallSegment
@@ -21,6 +21,7 @@
 
 #include "../impl/swap.h"
 #include "../impl/system.h"
+#include "../impl/thread.h"
 #include "../mem/zone.h"
 
 #include "../wad/wad.h"
@@ -136,6 +137,18 @@ short **texturecolumnlump;
 unsigned short **texturecolumnofs;
 byte **texturecomposite;
 
+// Texture atlas of the current level.  Every column of the textures
+//  the level's sides use is copied into one block, and
+//  texturecolumns[] points at the copies; NULL for other textures.
+static byte ***texturecolumns;
+static byte *textureatlas;
+static byte **atlascolumns;
+static int *atlastextures;
+static int numatlastextures;
+
+// Textures with a column no patch covers, left out of the atlas.
+static boolean *textureincomplete;
+
 // for global animation
 int *flattranslation;
 int *texturetranslation;
@@ -195,8 +208,7 @@ void R_DrawColumnInCache(column_t *patch, byte *cache, int originy, int cachehei
 //  the composite texture is created from the patches,
 //  and each column is cached.
 //
-void R_GenerateComposite(int texnum) {
-    byte *block;
+static void R_ComposeTexture(int texnum, byte *block) {
     texture_t *texture;
     texpatch_t *patch;
     patch_t *realpatch;
@@ -210,8 +222,6 @@ void R_GenerateComposite(int texnum) {
 
     texture = textures[texnum];
 
-    block = Z_Malloc(texturecompositesize[texnum], PU_STATIC, &texturecomposite[texnum]);
-
     collump = texturecolumnlump[texnum];
     colofs = texturecolumnofs[texnum];
 
@@ -238,6 +248,14 @@ void R_GenerateComposite(int texnum) {
             R_DrawColumnInCache(patchcol, block + colofs[x], patch->originy, texture->height);
         }
     }
+}
+
+void R_GenerateComposite(int texnum) {
+    byte *block;
+
+    block = Z_Malloc(texturecompositesize[texnum], PU_STATIC, &texturecomposite[texnum]);
+
+    R_ComposeTexture(texnum, block);
 
     // Now that the texture has been built in column cache,
     //  it is purgable from zone memory.
@@ -297,6 +315,7 @@ void R_GenerateLookup(int texnum) {
     for (x = 0; x < texture->width; x++) {
         if (!patchcount[x]) {
             printf("R_GenerateLookup: column without a patch (%s)\n", texture->name);
+            textureincomplete[texnum] = true;
             return;
         }
         // error ("R_GenerateLookup: column without a patch");
@@ -325,6 +344,10 @@ byte *R_GetColumn(int tex, int col) {
     int ofs;
 
     col &= texturewidthmask[tex];
+
+    if (texturecolumns[tex])
+        return texturecolumns[tex][col];
+
     lump = texturecolumnlump[tex][col];
     ofs = texturecolumnofs[tex][col];
 
@@ -333,10 +356,207 @@ byte *R_GetColumn(int tex, int col) {
 
     if (!texturecomposite[tex])
         R_GenerateComposite(tex);
+    else
+        Z_Touch(texturecomposite[tex]);
 
     return texturecomposite[tex] + ofs;
 }
 
+//
+// R_InitComposites
+// Builds every composite texture up front and keeps it resident,
+//  for strip threads which must not allocate while rendering.
+//
+void R_InitComposites(void) {
+    int i;
+    int x;
+
+    for (i = 0; i < numtextures; i++) {
+        for (x = 0; x < textures[i]->width; x++) {
+            if (texturecolumnlump[i][x] <= 0)
+                break;
+        }
+
+        // All columns come straight from patches.
+        if (x == textures[i]->width)
+            continue;
+
+        if (!texturecomposite[i])
+            R_GenerateComposite(i);
+
+        Z_ChangeTag(texturecomposite[i], PU_STATIC);
+    }
+}
+
+//
+// R_PatchColumnSize
+// Number of bytes of a patch column to copy into the atlas:
+//  the posts and their terminator, but at least the 128 bytes
+//  the wall drawers read, as far as the lump goes.
+//
+static int R_PatchColumnSize(int lump, int ofs) {
+    byte *column;
+    int avail;
+    int size;
+
+    column = (byte *)W_CacheLumpNum(lump, PU_CACHE) + ofs - 3;
+    avail = W_LumpLength(lump) - (ofs - 3);
+    size = 0;
+
+    while (size + 1 < avail && column[size] != 0xff)
+        size += column[size + 1] + 4;
+
+    size++;
+
+    if (size < 3 + 128)
+        size = 3 + 128;
+
+    if (size > avail)
+        size = avail;
+
+    return size;
+}
+
+//
+// R_FillTextureAtlas
+// Copies a share of the atlas textures into place.
+//
+static void R_FillTextureAtlas(int worker, int numworkers) {
+    short *collump;
+    unsigned short *colofs;
+    byte *source;
+    int i;
+    int tex;
+    int x;
+
+    for (i = worker; i < numatlastextures; i += numworkers) {
+        tex = atlastextures[i];
+        collump = texturecolumnlump[tex];
+        colofs = texturecolumnofs[tex];
+
+        for (x = 0; x < textures[tex]->width; x++) {
+            if (collump[x] > 0)
+                continue;
+
+            // The composite columns keep their layout, so that a column
+            //  shorter than 128 runs on into the next one as before.
+            R_ComposeTexture(tex, texturecolumns[tex][x] - colofs[x]);
+            break;
+        }
+
+        for (x = 0; x < textures[tex]->width; x++) {
+            if (collump[x] <= 0)
+                continue;
+
+            source = (byte *)W_CacheLumpNum(collump[x], PU_CACHE) + colofs[x] - 3;
+            memcpy(texturecolumns[tex][x] - 3, source, R_PatchColumnSize(collump[x], colofs[x]));
+        }
+    }
+}
+
+//
+// R_InitTextureAtlas
+// Builds the texture atlas for the level,
+//  so that R_GetColumn never has to composite
+//  or cache anything for the textures on its walls.
+//
+void R_InitTextureAtlas(void) {
+    char *texturepresent;
+    short *collump;
+    unsigned short *colofs;
+    byte *block;
+    byte *columns;
+    int numcolumns;
+    int size;
+    int tex;
+    int i;
+    int x;
+
+    if (textureatlas) {
+        Z_Free(textureatlas);
+        Z_Free(atlascolumns);
+        textureatlas = NULL;
+    }
+
+    memset(texturecolumns, 0, numtextures * sizeof(*texturecolumns));
+
+    texturepresent = Z_Malloc(numtextures, PU_STATIC, NULL);
+    memset(texturepresent, 0, numtextures);
+
+    for (i = 0; i < numsides; i++) {
+        texturepresent[sides[i].toptexture] = 1;
+        texturepresent[sides[i].midtexture] = 1;
+        texturepresent[sides[i].bottomtexture] = 1;
+    }
+
+    texturepresent[skytexture] = 1;
+
+    atlastextures = Z_Malloc(numtextures * sizeof(*atlastextures), PU_STATIC, NULL);
+    numatlastextures = 0;
+    numcolumns = 0;
+    size = 0;
+
+    for (i = 0; i < numtextures; i++) {
+        if (!texturepresent[i])
+            continue;
+
+        // A column without a patch has no lookup.
+        if (textureincomplete[i])
+            continue;
+
+        collump = texturecolumnlump[i];
+        atlastextures[numatlastextures++] = i;
+        numcolumns += textures[i]->width;
+        size += texturecompositesize[i];
+
+        for (x = 0; x < textures[i]->width; x++) {
+            if (collump[x] > 0)
+                size += R_PatchColumnSize(collump[x], texturecolumnofs[i][x]);
+        }
+    }
+
+    Z_Free(texturepresent);
+
+    textureatlas = Z_Malloc(size, PU_STATIC, NULL);
+    atlascolumns = Z_Malloc(numcolumns * sizeof(*atlascolumns), PU_STATIC, NULL);
+    memset(textureatlas, 0, size);
+
+    // Lay the textures out one after the other: the composite
+    //  columns first, then a copy of each patch column.
+    block = textureatlas;
+    numcolumns = 0;
+
+    for (i = 0; i < numatlastextures; i++) {
+        tex = atlastextures[i];
+        columns = block + texturecompositesize[tex];
+        collump = texturecolumnlump[tex];
+        colofs = texturecolumnofs[tex];
+        texturecolumns[tex] = atlascolumns + numcolumns;
+        numcolumns += textures[tex]->width;
+
+        for (x = 0; x < textures[tex]->width; x++) {
+            if (collump[x] > 0) {
+                texturecolumns[tex][x] = columns + 3;
+                columns += R_PatchColumnSize(collump[x], colofs[x]);
+            } else {
+                texturecolumns[tex][x] = block + colofs[x];
+            }
+        }
+
+        block = columns;
+    }
+
+    // Strip threads are only started if every lump is mapped,
+    //  so they can copy without going through the zone.
+    if (I_NumWorkers() > 1)
+        I_RunWorkers(R_FillTextureAtlas);
+    else
+        R_FillTextureAtlas(0, 1);
+
+    Z_Free(atlastextures);
+    atlastextures = NULL;
+}
+
 static void GenerateTextureHashTable(void) {
     texture_t **rover;
     int i;
@@ -448,6 +668,8 @@ void R_InitTextures(void) {
     texturecolumnlump = Z_Malloc(numtextures * sizeof(*texturecolumnlump), PU_STATIC, 0);
     texturecolumnofs = Z_Malloc(numtextures * sizeof(*texturecolumnofs), PU_STATIC, 0);
     texturecomposite = Z_Malloc(numtextures * sizeof(*texturecomposite), PU_STATIC, 0);
+    texturecolumns = Z_Malloc(numtextures * sizeof(*texturecolumns), PU_STATIC, 0);
+    textureincomplete = Z_Malloc(numtextures * sizeof(*textureincomplete), PU_STATIC, 0);
     texturecompositesize = Z_Malloc(numtextures * sizeof(*texturecompositesize), PU_STATIC, 0);
     texturewidthmask = Z_Malloc(numtextures * sizeof(*texturewidthmask), PU_STATIC, 0);
     textureheight = Z_Malloc(numtextures * sizeof(*textureheight), PU_STATIC, 0);
@@ -511,6 +733,8 @@ void R_InitTextures(void) {
         }
         texturecolumnlump[i] = Z_Malloc(texture->width * sizeof(**texturecolumnlump), PU_STATIC, 0);
         texturecolumnofs[i] = Z_Malloc(texture->width * sizeof(**texturecolumnofs), PU_STATIC, 0);
+        texturecolumns[i] = NULL;
+        textureincomplete[i] = false;
 
         j = 1;
         while (j * 2 <= texture->width)
@@ -28,6 +28,8 @@ byte *R_GetColumn(int tex, int col);
 
 // I/O, setting up the stuff.
 void R_InitData(void);
+void R_InitComposites(void);
+void R_InitTextureAtlas(void);
 void R_PrecacheLevel(void);
 
 // Retrieval.
@@ -43,6 +43,7 @@
 #define SIL_TOP 2
 #define SIL_BOTH 3
 
+// Initial size of the per-frame drawseg array, which grows as needed.
 #define MAXDRAWSEGS 256
 
 //
@@ -109,14 +110,39 @@ typedef struct {
     // list of mobjs in sector
     mobj_t *thinglist;
 
+    // list of blockmap mobjs touching the sector
+    struct secnode_s *touchlist;
+
     // thinker_t for reversable actions
     void *specialdata;
 
     int linecount;
     struct line_s **lines; // [linecount] size
 
+    // the two-sided lines, in the same order, with
+    //  the sector on the other side of each
+    int adjacentcount;
+    struct sectoradj_s *adjacent; // [adjacentcount] size
+
+    // Heights at the start of the tic, for interpolation.
+    fixed_t oldfloorheight;
+    fixed_t oldceilingheight;
+
+    // bumped whenever floorheight or ceilingheight changes
+    int version;
+
 } sector_t;
 
+//
+// An entry in a sector's adjacency list, built by P_GroupLines.
+//
+typedef struct sectoradj_s {
+    sector_t *sector; // on the other side of the line
+    struct line_s *line;
+    boolean soundblock; // line has ML_SOUNDBLOCK
+
+} sectoradj_t;
+
 //
 // The SideDef.
 //
@@ -366,7 +392,7 @@ typedef struct {
 //
 // Now what is a visplane, anyway?
 //
-typedef struct {
+typedef struct visplane_s {
     fixed_t height;
     int picnum;
     int lightlevel;
@@ -385,6 +411,9 @@ typedef struct {
     byte bottom[SCREENWIDTH];
     byte pad4;
 
+    // next plane in the same hash chain
+    struct visplane_s *next;
+
 } visplane_t;
 
 #endif
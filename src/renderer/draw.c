@@ -21,6 +21,7 @@
 #include "../game/def.h"
 
 #include "../impl/system.h"
+#include "../lib/argv.h"
 #include "../mem/zone.h"
 #include "../wad/wad.h"
 
@@ -32,6 +33,11 @@
 // State.
 #include "../game/stat.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAVE_SPAN_SIMD
+#endif
+
 // ?
 #define MAXWIDTH 1120
 #define MAXHEIGHT 832
@@ -57,6 +63,21 @@ int viewwindowy;
 pixel_t *ylookup[MAXHEIGHT];
 int columnofs[MAXWIDTH];
 
+// Columns of the view drawn by this thread.  Everything outside
+//  is clipped away by the column and span drawers.
+THREADLOCAL int stripx1;
+THREADLOCAL int stripx2 = SCREENWIDTH - 1;
+
+// With -transpose the view is drawn column-major into a buffer of
+//  its own, so that the pixels of a wall or sprite column are
+//  contiguous, and copied to I_VideoBuffer by R_TransposeView.
+static boolean transposeview = false;
+static pixel_t transposed[SCREENWIDTH * SCREENHEIGHT];
+
+// Distance between two pixels down a column and along a span.
+static int columnpitch = SCREENWIDTH;
+static int spanpitch = 1;
+
 // Color tables for different players,
 //  translate a limited part to another
 //  (color ramps used for  suit colors).
@@ -72,18 +93,18 @@ static pixel_t *background_buffer = NULL;
 // R_DrawColumn
 // Source is the top of the column to scale.
 //
-lighttable_t *dc_colormap;
-int dc_x;
-int dc_yl;
-int dc_yh;
-fixed_t dc_iscale;
-fixed_t dc_texturemid;
+THREADLOCAL lighttable_t *dc_colormap;
+THREADLOCAL int dc_x;
+THREADLOCAL int dc_yl;
+THREADLOCAL int dc_yh;
+THREADLOCAL fixed_t dc_iscale;
+THREADLOCAL fixed_t dc_texturemid;
 
 // first pixel in a column (possibly virtual)
-byte *dc_source;
+THREADLOCAL byte *dc_source;
 
 // just for profiling
-int dccount;
+THREADLOCAL int dccount;
 
 //
 // A column is a vertical slice/span from a wall texture that,
@@ -95,6 +116,7 @@ int dccount;
 void R_DrawColumn(void) {
     int count;
     pixel_t *dest;
+    int pitch;
     fixed_t frac;
     fixed_t fracstep;
 
@@ -104,6 +126,10 @@ void R_DrawColumn(void) {
     if (count < 0)
         return;
 
+    // Outside of this thread's strip.
+    if (dc_x < stripx1 || dc_x > stripx2)
+        return;
+
 #ifdef RANGECHECK
     if ((unsigned)dc_x >= SCREENWIDTH || dc_yl < 0 || dc_yh >= SCREENHEIGHT)
         error("R_DrawColumn: %i to %i at %i", dc_yl, dc_yh, dc_x);
@@ -112,6 +138,7 @@ void R_DrawColumn(void) {
     // Framebuffer destination address.
     // Use ylookup LUT to avoid multiply with ScreenWidth.
     // Use columnofs LUT for subwindows?
+    pitch = columnpitch;
     dest = ylookup[dc_yl] + columnofs[dc_x];
 
     // Determine scaling,
@@ -127,7 +154,7 @@ void R_DrawColumn(void) {
         //  using a lighting/special effects LUT.
         *dest = dc_colormap[dc_source[(frac >> FRACBITS) & 127]];
 
-        dest += SCREENWIDTH;
+        dest += pitch;
         frac += fracstep;
 
     } while (count--);
@@ -194,6 +221,7 @@ void R_DrawColumn (void)
 void R_DrawColumnLow(void) {
     int count;
     pixel_t *dest;
+    int pitch;
     pixel_t *dest2;
     fixed_t frac;
     fixed_t fracstep;
@@ -205,6 +233,9 @@ void R_DrawColumnLow(void) {
     if (count < 0)
         return;
 
+    if (dc_x < stripx1 || dc_x > stripx2)
+        return;
+
 #ifdef RANGECHECK
     if ((unsigned)dc_x >= SCREENWIDTH || dc_yl < 0 || dc_yh >= SCREENHEIGHT) {
 
@@ -215,6 +246,7 @@ void R_DrawColumnLow(void) {
     // Blocky mode, need to multiply by 2.
     x = dc_x << 1;
 
+    pitch = columnpitch;
     dest = ylookup[dc_yl] + columnofs[x];
     dest2 = ylookup[dc_yl] + columnofs[x + 1];
 
@@ -224,8 +256,8 @@ void R_DrawColumnLow(void) {
     do {
         // Hack. Does not work corretly.
         *dest2 = *dest = dc_colormap[dc_source[(frac >> FRACBITS) & 127]];
-        dest += SCREENWIDTH;
-        dest2 += SCREENWIDTH;
+        dest += pitch;
+        dest2 += pitch;
         frac += fracstep;
 
     } while (count--);
@@ -244,7 +276,7 @@ int fuzzoffset[FUZZTABLE] = {
     -FUZZOFF, FUZZOFF,  FUZZOFF,  -FUZZOFF, -FUZZOFF, FUZZOFF,  FUZZOFF,  -FUZZOFF, -FUZZOFF, -FUZZOFF,
     -FUZZOFF, FUZZOFF,  FUZZOFF,  FUZZOFF,  FUZZOFF,  -FUZZOFF, FUZZOFF,  FUZZOFF,  -FUZZOFF, FUZZOFF};
 
-int fuzzpos = 0;
+THREADLOCAL int fuzzpos = 0;
 
 //
 // Framebuffer postprocessing.
@@ -257,6 +289,7 @@ int fuzzpos = 0;
 void R_DrawFuzzColumn(void) {
     int count;
     pixel_t *dest;
+    int pitch;
 
     // Adjust borders. Low...
     if (!dc_yl)
@@ -272,12 +305,20 @@ void R_DrawFuzzColumn(void) {
     if (count < 0)
         return;
 
+    // Outside of this thread's strip: only keep the fuzz table in step,
+    //  so that the columns we do draw match a single-threaded render.
+    if (dc_x < stripx1 || dc_x > stripx2) {
+        fuzzpos = (fuzzpos + count + 1) % FUZZTABLE;
+        return;
+    }
+
 #ifdef RANGECHECK
     if ((unsigned)dc_x >= SCREENWIDTH || dc_yl < 0 || dc_yh >= SCREENHEIGHT) {
         error("R_DrawFuzzColumn: %i to %i at %i", dc_yl, dc_yh, dc_x);
     }
 #endif
 
+    pitch = columnpitch;
     dest = ylookup[dc_yl] + columnofs[dc_x];
 
     // Looks familiar.
@@ -296,7 +337,7 @@ void R_DrawFuzzColumn(void) {
         if (++fuzzpos == FUZZTABLE)
             fuzzpos = 0;
 
-        dest += SCREENWIDTH;
+        dest += pitch;
 
     } while (count--);
 }
@@ -306,6 +347,7 @@ void R_DrawFuzzColumn(void) {
 void R_DrawFuzzColumnLow(void) {
     int count;
     pixel_t *dest;
+    int pitch;
     pixel_t *dest2;
     int x;
 
@@ -323,6 +365,11 @@ void R_DrawFuzzColumnLow(void) {
     if (count < 0)
         return;
 
+    if (dc_x < stripx1 || dc_x > stripx2) {
+        fuzzpos = (fuzzpos + count + 1) % FUZZTABLE;
+        return;
+    }
+
     // low detail mode, need to multiply by 2
 
     x = dc_x << 1;
@@ -333,6 +380,7 @@ void R_DrawFuzzColumnLow(void) {
     }
 #endif
 
+    pitch = columnpitch;
     dest = ylookup[dc_yl] + columnofs[x];
     dest2 = ylookup[dc_yl] + columnofs[x + 1];
 
@@ -353,8 +401,8 @@ void R_DrawFuzzColumnLow(void) {
         if (++fuzzpos == FUZZTABLE)
             fuzzpos = 0;
 
-        dest += SCREENWIDTH;
-        dest2 += SCREENWIDTH;
+        dest += pitch;
+        dest2 += pitch;
 
     } while (count--);
 }
@@ -368,12 +416,13 @@ void R_DrawFuzzColumnLow(void) {
 //  of the BaronOfHell, the HellKnight, uses
 //  identical sprites, kinda brightened up.
 //
-byte *dc_translation;
+THREADLOCAL byte *dc_translation;
 byte *translationtables;
 
 void R_DrawTranslatedColumn(void) {
     int count;
     pixel_t *dest;
+    int pitch;
     fixed_t frac;
     fixed_t fracstep;
 
@@ -381,6 +430,9 @@ void R_DrawTranslatedColumn(void) {
     if (count < 0)
         return;
 
+    if (dc_x < stripx1 || dc_x > stripx2)
+        return;
+
 #ifdef RANGECHECK
     if ((unsigned)dc_x >= SCREENWIDTH || dc_yl < 0 || dc_yh >= SCREENHEIGHT) {
         error("R_DrawColumn: %i to %i at %i", dc_yl, dc_yh, dc_x);
@@ -388,6 +440,7 @@ void R_DrawTranslatedColumn(void) {
 
 #endif
 
+    pitch = columnpitch;
     dest = ylookup[dc_yl] + columnofs[dc_x];
 
     // Looks familiar.
@@ -402,7 +455,7 @@ void R_DrawTranslatedColumn(void) {
         // Thus the "green" ramp of the player 0 sprite
         //  is mapped to gray, red, black/indigo.
         *dest = dc_colormap[dc_translation[dc_source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
+        dest += pitch;
 
         frac += fracstep;
     } while (count--);
@@ -411,6 +464,7 @@ void R_DrawTranslatedColumn(void) {
 void R_DrawTranslatedColumnLow(void) {
     int count;
     pixel_t *dest;
+    int pitch;
     pixel_t *dest2;
     fixed_t frac;
     fixed_t fracstep;
@@ -420,6 +474,9 @@ void R_DrawTranslatedColumnLow(void) {
     if (count < 0)
         return;
 
+    if (dc_x < stripx1 || dc_x > stripx2)
+        return;
+
     // low detail, need to scale by 2
     x = dc_x << 1;
 
@@ -430,6 +487,7 @@ void R_DrawTranslatedColumnLow(void) {
 
 #endif
 
+    pitch = columnpitch;
     dest = ylookup[dc_yl] + columnofs[x];
     dest2 = ylookup[dc_yl] + columnofs[x + 1];
 
@@ -446,8 +504,8 @@ void R_DrawTranslatedColumnLow(void) {
         //  is mapped to gray, red, black/indigo.
         *dest = dc_colormap[dc_translation[dc_source[frac >> FRACBITS]]];
         *dest2 = dc_colormap[dc_translation[dc_source[frac >> FRACBITS]]];
-        dest += SCREENWIDTH;
-        dest2 += SCREENWIDTH;
+        dest += pitch;
+        dest2 += pitch;
 
         frac += fracstep;
     } while (count--);
@@ -491,30 +549,225 @@ void R_InitTranslationTables(void) {
 // In consequence, flats are not stored by column (like walls),
 //  and the inner loop has to step in texture space u and v.
 //
-int ds_y;
-int ds_x1;
-int ds_x2;
+THREADLOCAL int ds_y;
+THREADLOCAL int ds_x1;
+THREADLOCAL int ds_x2;
 
-lighttable_t *ds_colormap;
+THREADLOCAL lighttable_t *ds_colormap;
 
-fixed_t ds_xfrac;
-fixed_t ds_yfrac;
-fixed_t ds_xstep;
-fixed_t ds_ystep;
+THREADLOCAL fixed_t ds_xfrac;
+THREADLOCAL fixed_t ds_yfrac;
+THREADLOCAL fixed_t ds_xstep;
+THREADLOCAL fixed_t ds_ystep;
 
 // start of a 64*64 tile image
-byte *ds_source;
+THREADLOCAL byte *ds_source;
 
 // just for profiling
-int dscount;
+THREADLOCAL int dscount;
+
+//
+// Span kernels.
+// Write count colormapped texels of a span to dest.  The SIMD
+//  versions work out the texel offsets of 8 or 16 pixels at once
+//  and then look them up; the packed position wraps the same way
+//  in every lane, so the output matches the scalar loop exactly.
+//
+typedef void (*spankernel_t)(pixel_t *dest, const byte *source, const lighttable_t *colormap,
+                             unsigned int position, unsigned int step, int count);
+
+static void R_SpanKernel(pixel_t *dest, const byte *source, const lighttable_t *colormap, unsigned int position,
+                         unsigned int step, int count) {
+    int spot;
+
+    while (count-- > 0) {
+        // Calculate current texture index in u,v.
+        unsigned int xtemp = (position >> 26);
+        unsigned int ytemp = (position >> 4) & 0x0fc0;
+
+        spot = xtemp | ytemp;
+
+        // Lookup pixel from flat texture tile,
+        //  re-index using light/colormap.
+        *dest++ = colormap[source[spot]];
+
+        position += step;
+    }
+}
+
+#ifdef HAVE_SPAN_SIMD
+
+__attribute__((target("sse2"))) static void R_SpanKernelSSE2(pixel_t *dest, const byte *source,
+                                                            const lighttable_t *colormap, unsigned int position,
+                                                            unsigned int step, int count) {
+    __attribute__((aligned(16))) unsigned int spots[8];
+    __m128i pos0;
+    __m128i pos1;
+    __m128i step8;
+    __m128i ymask;
+    __m128i spot0;
+    __m128i spot1;
+    int i;
+
+    pos0 = _mm_setr_epi32(position, position + step, position + 2 * step, position + 3 * step);
+    pos1 = _mm_add_epi32(pos0, _mm_set1_epi32(4 * step));
+    step8 = _mm_set1_epi32(8 * step);
+    ymask = _mm_set1_epi32(0x0fc0);
+
+    while (count >= 8) {
+        spot0 = _mm_or_si128(_mm_srli_epi32(pos0, 26), _mm_and_si128(_mm_srli_epi32(pos0, 4), ymask));
+        spot1 = _mm_or_si128(_mm_srli_epi32(pos1, 26), _mm_and_si128(_mm_srli_epi32(pos1, 4), ymask));
+        _mm_store_si128((__m128i *)spots, spot0);
+        _mm_store_si128((__m128i *)(spots + 4), spot1);
+
+        for (i = 0; i < 8; i++)
+            dest[i] = colormap[source[spots[i]]];
+
+        pos0 = _mm_add_epi32(pos0, step8);
+        pos1 = _mm_add_epi32(pos1, step8);
+        position += 8 * step;
+        dest += 8;
+        count -= 8;
+    }
+
+    R_SpanKernel(dest, source, colormap, position, step, count);
+}
+
+__attribute__((target("avx2"))) static void R_SpanKernelAVX2(pixel_t *dest, const byte *source,
+                                                            const lighttable_t *colormap, unsigned int position,
+                                                            unsigned int step, int count) {
+    __attribute__((aligned(32))) unsigned int spots[16];
+    __m256i pos0;
+    __m256i pos1;
+    __m256i step16;
+    __m256i ymask;
+    __m256i spot0;
+    __m256i spot1;
+    int i;
+
+    pos0 = _mm256_setr_epi32(position, position + step, position + 2 * step, position + 3 * step,
+                             position + 4 * step, position + 5 * step, position + 6 * step, position + 7 * step);
+    pos1 = _mm256_add_epi32(pos0, _mm256_set1_epi32(8 * step));
+    step16 = _mm256_set1_epi32(16 * step);
+    ymask = _mm256_set1_epi32(0x0fc0);
+
+    while (count >= 16) {
+        spot0 = _mm256_or_si256(_mm256_srli_epi32(pos0, 26), _mm256_and_si256(_mm256_srli_epi32(pos0, 4), ymask));
+        spot1 = _mm256_or_si256(_mm256_srli_epi32(pos1, 26), _mm256_and_si256(_mm256_srli_epi32(pos1, 4), ymask));
+        _mm256_store_si256((__m256i *)spots, spot0);
+        _mm256_store_si256((__m256i *)(spots + 8), spot1);
+
+        for (i = 0; i < 16; i++)
+            dest[i] = colormap[source[spots[i]]];
+
+        pos0 = _mm256_add_epi32(pos0, step16);
+        pos1 = _mm256_add_epi32(pos1, step16);
+        position += 16 * step;
+        dest += 16;
+        count -= 16;
+    }
+
+    R_SpanKernelSSE2(dest, source, colormap, position, step, count);
+}
+
+#endif
+
+//
+// Transpose kernels.
+// Copy a block of the column-major view into the screen buffer.
+//
+typedef void (*transposeblock_t)(pixel_t *dest, const pixel_t *src);
+
+static void R_TransposeEdge(pixel_t *dest, const pixel_t *src, int width, int height) {
+    int x, y;
+
+    for (y = 0; y < height; y++)
+        for (x = 0; x < width; x++)
+            dest[y * SCREENWIDTH + x] = src[x * SCREENHEIGHT + y];
+}
+
+static void R_TransposeBlock(pixel_t *dest, const pixel_t *src) {
+    R_TransposeEdge(dest, src, 8, 8);
+}
+
+#ifdef HAVE_SPAN_SIMD
+
+__attribute__((target("sse2"))) static void R_TransposeBlockSSE2(pixel_t *dest, const pixel_t *src) {
+    __m128i a0, a1, a2, a3;
+    __m128i b0, b1, b2, b3;
+    __m128i c[4];
+    int i;
+
+#define COLUMN(n) _mm_loadl_epi64((const __m128i *)(src + (n) * SCREENHEIGHT))
+
+    // Interleave bytes, then words, then dwords of the eight columns;
+    //  each of c[] ends up holding two rows of the block.
+    a0 = _mm_unpacklo_epi8(COLUMN(0), COLUMN(1));
+    a1 = _mm_unpacklo_epi8(COLUMN(2), COLUMN(3));
+    a2 = _mm_unpacklo_epi8(COLUMN(4), COLUMN(5));
+    a3 = _mm_unpacklo_epi8(COLUMN(6), COLUMN(7));
+
+#undef COLUMN
+
+    b0 = _mm_unpacklo_epi16(a0, a1);
+    b1 = _mm_unpackhi_epi16(a0, a1);
+    b2 = _mm_unpacklo_epi16(a2, a3);
+    b3 = _mm_unpackhi_epi16(a2, a3);
+
+    c[0] = _mm_unpacklo_epi32(b0, b2);
+    c[1] = _mm_unpackhi_epi32(b0, b2);
+    c[2] = _mm_unpacklo_epi32(b1, b3);
+    c[3] = _mm_unpackhi_epi32(b1, b3);
+
+    for (i = 0; i < 4; i++) {
+        _mm_storel_epi64((__m128i *)(dest + 2 * i * SCREENWIDTH), c[i]);
+        _mm_storel_epi64((__m128i *)(dest + (2 * i + 1) * SCREENWIDTH), _mm_unpackhi_epi64(c[i], c[i]));
+    }
+}
+
+#endif
+
+static spankernel_t spankernel = R_SpanKernel;
+static transposeblock_t transposeblock = R_TransposeBlock;
+
+//
+// R_InitSpanKernel
+// Picks the fastest span and transpose kernels the CPU supports.
+//
+void R_InitSpanKernel(void) {
+    spankernel = R_SpanKernel;
+    transposeblock = R_TransposeBlock;
+
+    //!
+    // @category obscure
+    //
+    // Draw without the SSE2/AVX2 span and transpose kernels.
+    //
+
+    if (M_ParmExists("-nosimd"))
+        return;
+
+#ifdef HAVE_SPAN_SIMD
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+        spankernel = R_SpanKernelAVX2;
+    else if (__builtin_cpu_supports("sse2"))
+        spankernel = R_SpanKernelSSE2;
+
+    if (__builtin_cpu_supports("sse2"))
+        transposeblock = R_TransposeBlockSSE2;
+#endif
+}
 
 //
 // Draws the actual span.
 void R_DrawSpan(void) {
     unsigned int position, step;
     pixel_t *dest;
+    pixel_t texels[SCREENWIDTH];
     int count;
-    int spot;
+    int i;
 
 #ifdef RANGECHECK
     if (ds_x2 < ds_x1 || ds_x1 < 0 || ds_x2 >= SCREENWIDTH || (unsigned)ds_y > SCREENHEIGHT) {
@@ -531,25 +784,34 @@ void R_DrawSpan(void) {
     position = ((ds_xfrac << 10) & 0xffff0000) | ((ds_yfrac >> 6) & 0x0000ffff);
     step = ((ds_xstep << 10) & 0xffff0000) | ((ds_ystep >> 6) & 0x0000ffff);
 
-    dest = ylookup[ds_y] + columnofs[ds_x1];
+    // Clip to this thread's strip, stepping the position on as if
+    //  the span had been drawn from its start.
+    if (ds_x1 < stripx1) {
+        position += step * (stripx1 - ds_x1);
+        ds_x1 = stripx1;
+    }
 
-    // We do not check for zero spans here?
-    count = ds_x2 - ds_x1;
+    if (ds_x2 > stripx2)
+        ds_x2 = stripx2;
 
-    do {
-        // Calculate current texture index in u,v.
-        unsigned int xtemp = (position >> 26);
-        unsigned int ytemp = (position >> 4) & 0x0fc0;
+    if (ds_x2 < ds_x1)
+        return;
 
-        spot = xtemp | ytemp;
+    dest = ylookup[ds_y] + columnofs[ds_x1];
 
-        // Lookup pixel from flat texture tile,
-        //  re-index using light/colormap.
-        *dest++ = ds_colormap[ds_source[spot]];
+    // We do not check for zero spans here?
+    count = ds_x2 - ds_x1 + 1;
 
-        position += step;
+    if (spanpitch == 1) {
+        spankernel(dest, ds_source, ds_colormap, position, step, count);
+        return;
+    }
 
-    } while (count--);
+    // Transposed view: draw the span and scatter it down the row.
+    spankernel(texels, ds_source, ds_colormap, position, step, count);
+
+    for (i = 0; i < count; i++, dest += spanpitch)
+        *dest = texels[i];
 }
 
 // UNUSED.
@@ -630,8 +892,9 @@ void R_DrawSpan (void)
 void R_DrawSpanLow(void) {
     unsigned int position, step;
     pixel_t *dest;
+    pixel_t texels[SCREENWIDTH];
     int count;
-    int spot;
+    int i;
 
 #ifdef RANGECHECK
     if (ds_x2 < ds_x1 || ds_x1 < 0 || ds_x2 >= SCREENWIDTH || (unsigned)ds_y > SCREENHEIGHT) {
@@ -643,29 +906,36 @@ void R_DrawSpanLow(void) {
     position = ((ds_xfrac << 10) & 0xffff0000) | ((ds_yfrac >> 6) & 0x0000ffff);
     step = ((ds_xstep << 10) & 0xffff0000) | ((ds_ystep >> 6) & 0x0000ffff);
 
-    count = (ds_x2 - ds_x1);
+    // Clip to this thread's strip, stepping the position on as if
+    //  the span had been drawn from its start.
+    if (ds_x1 < stripx1) {
+        position += step * (stripx1 - ds_x1);
+        ds_x1 = stripx1;
+    }
 
-    // Blocky mode, need to multiply by 2.
-    ds_x1 <<= 1;
-    ds_x2 <<= 1;
+    if (ds_x2 > stripx2)
+        ds_x2 = stripx2;
 
-    dest = ylookup[ds_y] + columnofs[ds_x1];
+    if (ds_x2 < ds_x1)
+        return;
 
-    do {
-        // Calculate current texture index in u,v.
-        unsigned int ytemp = (position >> 4) & 0x0fc0;
-        unsigned int xtemp = (position >> 26);
+    count = ds_x2 - ds_x1 + 1;
 
-        spot = xtemp | ytemp;
+    spankernel(texels, ds_source, ds_colormap, position, step, count);
 
-        // Lowres/blocky mode does it twice,
-        //  while scale is adjusted appropriately.
-        *dest++ = ds_colormap[ds_source[spot]];
-        *dest++ = ds_colormap[ds_source[spot]];
+    // Blocky mode, need to multiply by 2.
+    ds_x1 <<= 1;
+    ds_x2 <<= 1;
 
-        position += step;
+    dest = ylookup[ds_y] + columnofs[ds_x1];
 
-    } while (count--);
+    // Lowres/blocky mode does it twice,
+    //  while scale is adjusted appropriately.
+    for (i = 0; i < count; i++) {
+        dest[0] = texels[i];
+        dest[spanpitch] = texels[i];
+        dest += 2 * spanpitch;
+    }
 }
 
 //
@@ -696,6 +966,72 @@ void R_InitBuffer(int width, int height) {
     // Preclaculate all row offsets.
     for (i = 0; i < height; i++)
         ylookup[i] = I_VideoBuffer + (i + viewwindowy) * SCREENWIDTH;
+
+    // The transposed buffer holds the view only, one column after
+    //  the other; R_TransposeView places it in the window.
+    if (transposeview) {
+        for (i = 0; i < width; i++)
+            columnofs[i] = i * SCREENHEIGHT;
+
+        for (i = 0; i < height; i++)
+            ylookup[i] = transposed + i;
+    }
+}
+
+//
+// R_InitTransposedView
+//
+void R_InitTransposedView(void) {
+    int i;
+
+    //!
+    // @category video
+    //
+    // Draw the 3D view column-major and transpose it into the
+    // screen buffer at the end of the frame.
+    //
+
+    transposeview = M_ParmExists("-transpose");
+
+    if (!transposeview)
+        return;
+
+    columnpitch = 1;
+    spanpitch = SCREENHEIGHT;
+
+    // The fuzz effect samples the pixels above and below.
+    for (i = 0; i < FUZZTABLE; i++)
+        fuzzoffset[i] = fuzzoffset[i] > 0 ? columnpitch : -columnpitch;
+}
+
+//
+// R_TransposeView
+// Copies screen columns x1 to x2 of the transposed view
+//  into the view window of I_VideoBuffer.
+//
+void R_TransposeView(int x1, int x2) {
+    pixel_t *src;
+    pixel_t *dest;
+    int x, y;
+    int bx, by;
+
+    if (!transposeview)
+        return;
+
+    for (x = x1; x <= x2; x += 8) {
+        bx = x2 + 1 - x < 8 ? x2 + 1 - x : 8;
+
+        for (y = 0; y < viewheight; y += 8) {
+            by = viewheight - y < 8 ? viewheight - y : 8;
+            src = transposed + x * SCREENHEIGHT + y;
+            dest = I_VideoBuffer + (viewwindowy + y) * SCREENWIDTH + viewwindowx + x;
+
+            if (bx == 8 && by == 8)
+                transposeblock(dest, src);
+            else
+                R_TransposeEdge(dest, src, bx, by);
+        }
+    }
 }
 
 //
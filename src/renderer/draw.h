@@ -19,15 +19,19 @@
 #ifndef __R_DRAW__
 #define __R_DRAW__
 
-extern lighttable_t *dc_colormap;
-extern int dc_x;
-extern int dc_yl;
-extern int dc_yh;
-extern fixed_t dc_iscale;
-extern fixed_t dc_texturemid;
+extern THREADLOCAL lighttable_t *dc_colormap;
+extern THREADLOCAL int dc_x;
+extern THREADLOCAL int dc_yl;
+extern THREADLOCAL int dc_yh;
+extern THREADLOCAL fixed_t dc_iscale;
+extern THREADLOCAL fixed_t dc_texturemid;
 
 // first pixel in a column
-extern byte *dc_source;
+extern THREADLOCAL byte *dc_source;
+
+extern THREADLOCAL int stripx1;
+extern THREADLOCAL int stripx2;
+extern THREADLOCAL int fuzzpos;
 
 // The span blitting interface.
 // Hook in assembler or system specific BLT
@@ -47,25 +51,27 @@ void R_DrawTranslatedColumnLow(void);
 
 void R_VideoErase(unsigned ofs, int count);
 
-extern int ds_y;
-extern int ds_x1;
-extern int ds_x2;
+extern THREADLOCAL int ds_y;
+extern THREADLOCAL int ds_x1;
+extern THREADLOCAL int ds_x2;
 
-extern lighttable_t *ds_colormap;
+extern THREADLOCAL lighttable_t *ds_colormap;
 
-extern fixed_t ds_xfrac;
-extern fixed_t ds_yfrac;
-extern fixed_t ds_xstep;
-extern fixed_t ds_ystep;
+extern THREADLOCAL fixed_t ds_xfrac;
+extern THREADLOCAL fixed_t ds_yfrac;
+extern THREADLOCAL fixed_t ds_xstep;
+extern THREADLOCAL fixed_t ds_ystep;
 
 // start of a 64*64 tile image
-extern byte *ds_source;
+extern THREADLOCAL byte *ds_source;
 
 extern byte *translationtables;
-extern byte *dc_translation;
+extern THREADLOCAL byte *dc_translation;
 
 // Span blitting for rows, floor/ceiling.
 // No Sepctre effect needed.
+void R_InitSpanKernel(void);
+
 void R_DrawSpan(void);
 
 // Low resolution mode, 160x200?
@@ -73,6 +79,11 @@ void R_DrawSpanLow(void);
 
 void R_InitBuffer(int width, int height);
 
+void R_InitTransposedView(void);
+
+// Copy screen columns x1 to x2 of a transposed view to the screen.
+void R_TransposeView(int x1, int x2);
+
 // Initialize color translation tables,
 //  for player rendering etc.
 void R_InitTranslationTables(void);
@@ -37,6 +37,7 @@
 #include "draw.h"
 #include "main.h"
 #include "plane.h"
+#include "queue.h"
 #include "segs.h"
 #include "things.h"
 
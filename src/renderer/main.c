@@ -18,14 +18,21 @@
 //	See tables.c, too.
 //
 
+#include <limits.h>
 #include <math.h>
 #include <stdlib.h>
 
 #include "../game/def.h"
 #include "../game/loop.h"
+#include "../game/stat.h"
 
+#include "../impl/system.h"
+#include "../impl/thread.h"
+#include "../lib/argv.h"
 #include "../menu/menu.h"
 #include "../misc/bbox.h"
+#include "../player/setup.h"
+#include "../wad/wad.h"
 
 #include "local.h"
 #include "sky.h"
@@ -39,7 +46,7 @@ int viewangleoffset;
 int validcount = 1;
 
 lighttable_t *fixedcolormap;
-extern lighttable_t **walllights;
+extern THREADLOCAL lighttable_t **walllights;
 
 int centerx;
 int centery;
@@ -51,7 +58,29 @@ fixed_t projection;
 // just for profiling purposes
 int framecount;
 
-int sscount;
+// Subsector lookup grid, 64 unit cells unless the map is huge.
+#define POINTGRIDSHIFT (FRACBITS + 6)
+#define MAXPOINTGRIDCELLS (512 * 512)
+
+static unsigned short *pointgrid;
+static int pointgridshift;
+static int pointgridwidth;
+static int pointgridheight;
+static fixed_t pointgridx;
+static fixed_t pointgridy;
+
+// Memory for things that only last one frame, reset by R_SetupStrip.
+#define FRAMEARENA_SIZE (256 * 1024)
+
+THREADLOCAL arena_t framearena = {NULL, NULL, FRAMEARENA_SIZE, 0, 0};
+
+// Most drawsegs, vissprites and openings used by a single frame.
+int peakdrawsegs;
+int peakvissprites;
+int peakopenings;
+static size_t peakframememory;
+
+THREADLOCAL int sscount;
 int linecount;
 int loopcount;
 
@@ -66,6 +95,16 @@ fixed_t viewsin;
 
 player_t *viewplayer;
 
+// How far to draw moving things and planes from where the last
+//  tic started them towards where it left them.  FRACUNIT unless
+//  the framerate is uncapped.
+fixed_t fractionaltic = FRACUNIT;
+
+// Sector heights of the last tic, while the interpolated
+//  heights are in place for drawing.
+static fixed_t *sectorheights;
+static int numsectorheights;
+
 // 0 = high, 1 = low
 int detailshift;
 
@@ -92,11 +131,12 @@ lighttable_t *zlight[LIGHTLEVELS][MAXLIGHTZ];
 // bumped light from gun blasts
 int extralight;
 
-void (*colfunc)(void);
+THREADLOCAL void (*colfunc)(void);
 void (*basecolfunc)(void);
 void (*fuzzcolfunc)(void);
 void (*transcolfunc)(void);
-void (*spanfunc)(void);
+void (*basespanfunc)(void);
+THREADLOCAL void (*spanfunc)(void);
 
 //
 // R_PointOnSide
@@ -558,12 +598,12 @@ void R_ExecuteSetViewSize(void) {
         colfunc = basecolfunc = R_DrawColumn;
         fuzzcolfunc = R_DrawFuzzColumn;
         transcolfunc = R_DrawTranslatedColumn;
-        spanfunc = R_DrawSpan;
+        spanfunc = basespanfunc = R_DrawSpan;
     } else {
         colfunc = basecolfunc = R_DrawColumnLow;
         fuzzcolfunc = R_DrawFuzzColumnLow;
         transcolfunc = R_DrawTranslatedColumnLow;
-        spanfunc = R_DrawSpanLow;
+        spanfunc = basespanfunc = R_DrawSpanLow;
     }
 
     R_InitBuffer(scaledviewwidth, viewheight);
@@ -608,6 +648,73 @@ void R_ExecuteSetViewSize(void) {
     }
 }
 
+//
+// R_InitStrips
+// Starts the threads that render the view in vertical strips.
+// Strip threads read lumps and composite textures without
+//  going through the zone, so every lump has to be mapped.
+//
+static void R_InitStrips(void) {
+    int threads;
+    int p;
+    int i;
+
+    //!
+    // @category video
+    // @arg <n>
+    //
+    // Render the 3D view with n threads, each drawing a vertical
+    // strip of the screen. The output is identical to rendering
+    // with a single thread.
+    //
+
+    p = M_CheckParmWithArgs("-renderthreads", 1);
+
+    if (p <= 0)
+        return;
+
+    threads = atoi(myargv[p + 1]);
+
+    if (threads <= 1)
+        return;
+
+    for (i = 0; i < numlumps; i++) {
+        if (lumpinfo[i]->wad_file->mapped == NULL) {
+            printf("R_InitStrips: WAD files are not memory mapped (use -mmap), using one thread.\n");
+            return;
+        }
+    }
+
+    I_InitWorkers(threads);
+    R_InitComposites();
+}
+
+//
+// R_UpdateFrameStats
+// Every strip sees the whole frame, so only the first is counted.
+//
+static void R_UpdateFrameStats(void) {
+    if (stripx1)
+        return;
+
+    if (ds_p - drawsegs > peakdrawsegs)
+        peakdrawsegs = ds_p - drawsegs;
+
+    if (vissprite_p - vissprites > peakvissprites)
+        peakvissprites = vissprite_p - vissprites;
+
+    if (numopenings > peakopenings)
+        peakopenings = numopenings;
+
+    if (framearena.peak > peakframememory)
+        peakframememory = framearena.peak;
+}
+
+static void R_PrintFrameStats(void) {
+    printf("R_FrameStats: peak %i drawsegs, %i vissprites, %i openings, %" PRIuPTR " bytes of frame memory\n",
+           peakdrawsegs, peakvissprites, peakopenings, (uintptr_t)peakframememory);
+}
+
 //
 // R_Init
 //
@@ -628,11 +735,174 @@ void R_Init(void) {
     printf(".");
     R_InitSkyMap();
     R_InitTranslationTables();
+    R_InitTransposedView();
+    R_InitSpanKernel();
+    R_InitStrips();
+    R_InitDrawQueue();
+
+    if (devparm)
+        I_AtExit(R_PrintFrameStats, false);
     printf(".");
 
     framecount = 0;
 }
 
+//
+// R_BoxOnNodeSide
+// Returns the side of a node's partition line that R_PointOnSide
+// gives for every point in the box, or -1 if that isn't certain.
+//
+static int R_BoxOnNodeSide(fixed_t x1, fixed_t y1, fixed_t x2, fixed_t y2, node_t *node) {
+    int64_t dx1, dy1, dx2, dy2;
+    int64_t left1, left2, right1, right2;
+
+    if (!node->dx) {
+        if (x2 <= node->x)
+            return node->dy > 0;
+        if (x1 > node->x)
+            return node->dy < 0;
+
+        return -1;
+    }
+    if (!node->dy) {
+        if (y2 <= node->y)
+            return node->dx < 0;
+        if (y1 > node->y)
+            return node->dx > 0;
+
+        return -1;
+    }
+
+    dx1 = (int64_t)x1 - node->x;
+    dx2 = (int64_t)x2 - node->x;
+    dy1 = (int64_t)y1 - node->y;
+    dy2 = (int64_t)y2 - node->y;
+
+    // dx and dy must neither wrap nor change sign inside the box,
+    // so the sign bit test goes the same way for all of it.
+    if (dx1 < INT_MIN || dx2 > INT_MAX || dy1 < INT_MIN || dy2 > INT_MAX)
+        return -1;
+    if ((dx1 < 0) != (dx2 < 0) || (dy1 < 0) != (dy2 < 0))
+        return -1;
+
+    if ((node->dy ^ node->dx ^ (fixed_t)dx1 ^ (fixed_t)dy1) & 0x80000000)
+        return ((node->dy ^ (fixed_t)dx1) & 0x80000000) != 0;
+
+    // left only depends on dx and right on dy, and both are monotonic
+    // as long as FixedMul doesn't overflow at the corners.
+    left1 = ((node->dy >> FRACBITS) * dx1) >> FRACBITS;
+    left2 = ((node->dy >> FRACBITS) * dx2) >> FRACBITS;
+    right1 = (dy1 * (node->dx >> FRACBITS)) >> FRACBITS;
+    right2 = (dy2 * (node->dx >> FRACBITS)) >> FRACBITS;
+
+    if (left1 < INT_MIN || left1 > INT_MAX || left2 < INT_MIN || left2 > INT_MAX)
+        return -1;
+    if (right1 < INT_MIN || right1 > INT_MAX || right2 < INT_MIN || right2 > INT_MAX)
+        return -1;
+
+    if (left1 > left2) {
+        int64_t swap = left1;
+        left1 = left2;
+        left2 = swap;
+    }
+    if (right1 > right2) {
+        int64_t swap = right1;
+        right1 = right2;
+        right2 = swap;
+    }
+
+    if (right2 < left1)
+        return 0;
+    if (right1 >= left2)
+        return 1;
+
+    return -1;
+}
+
+//
+// R_InitPointGrid
+// Called after the nodes are loaded.  Each grid cell holds the
+// deepest node, or the subsector, whose subtree covers all of it,
+// so R_PointInSubsector can start from there instead of the root.
+//
+void R_InitPointGrid(void) {
+    node_t *root;
+    node_t *node;
+    int64_t left, right, bottom, top;
+    int64_t x1, y1, x2, y2;
+    int nodenum;
+    int side;
+    int cx, cy;
+
+    pointgrid = NULL;
+
+    if (!numnodes)
+        return;
+
+    root = &nodes[numnodes - 1];
+
+    left = root->bbox[0][BOXLEFT];
+    right = root->bbox[0][BOXRIGHT];
+    bottom = root->bbox[0][BOXBOTTOM];
+    top = root->bbox[0][BOXTOP];
+
+    if (root->bbox[1][BOXLEFT] < left)
+        left = root->bbox[1][BOXLEFT];
+    if (root->bbox[1][BOXRIGHT] > right)
+        right = root->bbox[1][BOXRIGHT];
+    if (root->bbox[1][BOXBOTTOM] < bottom)
+        bottom = root->bbox[1][BOXBOTTOM];
+    if (root->bbox[1][BOXTOP] > top)
+        top = root->bbox[1][BOXTOP];
+
+    // Coarser cells for huge maps.
+    pointgridshift = POINTGRIDSHIFT;
+
+    for (;;) {
+        pointgridwidth = (int)((right - left) >> pointgridshift) + 1;
+        pointgridheight = (int)((top - bottom) >> pointgridshift) + 1;
+
+        if (pointgridwidth * pointgridheight <= MAXPOINTGRIDCELLS)
+            break;
+
+        pointgridshift++;
+    }
+
+    pointgridx = (fixed_t)left;
+    pointgridy = (fixed_t)bottom;
+    pointgrid = Z_ArenaAlloc(&levelarena, pointgridwidth * pointgridheight * sizeof(*pointgrid));
+
+    for (cy = 0; cy < pointgridheight; cy++) {
+        y1 = bottom + ((int64_t)cy << pointgridshift);
+        y2 = y1 + ((int64_t)1 << pointgridshift) - 1;
+
+        if (y2 > INT_MAX)
+            y2 = INT_MAX;
+
+        for (cx = 0; cx < pointgridwidth; cx++) {
+            x1 = left + ((int64_t)cx << pointgridshift);
+            x2 = x1 + ((int64_t)1 << pointgridshift) - 1;
+
+            if (x2 > INT_MAX)
+                x2 = INT_MAX;
+
+            nodenum = numnodes - 1;
+
+            while (!(nodenum & NF_SUBSECTOR)) {
+                node = &nodes[nodenum];
+                side = R_BoxOnNodeSide((fixed_t)x1, (fixed_t)y1, (fixed_t)x2, (fixed_t)y2, node);
+
+                if (side < 0)
+                    break;
+
+                nodenum = node->children[side];
+            }
+
+            pointgrid[cy * pointgridwidth + cx] = nodenum;
+        }
+    }
+}
+
 //
 // R_PointInSubsector
 //
@@ -640,6 +910,7 @@ subsector_t *R_PointInSubsector(fixed_t x, fixed_t y) {
     node_t *node;
     int side;
     int nodenum;
+    unsigned int cx, cy;
 
     // single subsector is a special case
     if (!numnodes)
@@ -647,6 +918,15 @@ subsector_t *R_PointInSubsector(fixed_t x, fixed_t y) {
 
     nodenum = numnodes - 1;
 
+    if (pointgrid != NULL) {
+        cx = ((unsigned int)x - (unsigned int)pointgridx) >> pointgridshift;
+        cy = ((unsigned int)y - (unsigned int)pointgridy) >> pointgridshift;
+
+        // Points off the grid wrap around to huge cell numbers.
+        if (cx < (unsigned int)pointgridwidth && cy < (unsigned int)pointgridheight)
+            nodenum = pointgrid[cy * pointgridwidth + cx];
+    }
+
     while (!(nodenum & NF_SUBSECTOR)) {
         node = &nodes[nodenum];
         side = R_PointOnSide(x, y, node);
@@ -663,12 +943,20 @@ void R_SetupFrame(player_t *player) {
     int i;
 
     viewplayer = player;
-    viewx = player->mo->x;
-    viewy = player->mo->y;
-    viewangle = player->mo->angle + viewangleoffset;
-    extralight = player->extralight;
 
-    viewz = player->viewz;
+    if (fractionaltic < FRACUNIT) {
+        viewx = R_Lerp(MO_OLDX(player->mo), player->mo->x);
+        viewy = R_Lerp(MO_OLDY(player->mo), player->mo->y);
+        viewangle = R_LerpAngle(MO_OLDANGLE(player->mo), player->mo->angle) + viewangleoffset;
+        viewz = R_Lerp(player->oldviewz, player->viewz);
+    } else {
+        viewx = player->mo->x;
+        viewy = player->mo->y;
+        viewangle = player->mo->angle + viewangleoffset;
+        viewz = player->viewz;
+    }
+
+    extralight = player->extralight;
 
     viewsin = finesine[viewangle >> ANGLETOFINESHIFT];
     viewcos = finecosine[viewangle >> ANGLETOFINESHIFT];
@@ -678,8 +966,6 @@ void R_SetupFrame(player_t *player) {
     if (player->fixedcolormap) {
         fixedcolormap = colormaps + player->fixedcolormap * 256;
 
-        walllights = scalelightfixed;
-
         for (i = 0; i < MAXLIGHTSCALE; i++)
             scalelightfixed[i] = fixedcolormap;
     } else
@@ -689,12 +975,119 @@ void R_SetupFrame(player_t *player) {
     validcount++;
 }
 
+//
+// R_Lerp
+// Interpolates between the start and end of the last tic.
+//
+fixed_t R_Lerp(fixed_t from, fixed_t to) { return from + FixedMul(to - from, fractionaltic); }
+
+angle_t R_LerpAngle(angle_t from, angle_t to) { return from + FixedMul((int)(to - from), fractionaltic); }
+
+//
+// R_InterpolateSectors
+// Moves the floors and ceilings in between tics for drawing.
+//  The playsim never runs while they are moved.
+//
+static void R_InterpolateSectors(void) {
+    sector_t *sec;
+    int i;
+
+    if (numsectorheights < numsectors) {
+        sectorheights = I_Realloc(sectorheights, 2 * numsectors * sizeof(*sectorheights));
+        numsectorheights = numsectors;
+    }
+
+    for (i = 0, sec = sectors; i < numsectors; i++, sec++) {
+        sectorheights[2 * i] = sec->floorheight;
+        sectorheights[2 * i + 1] = sec->ceilingheight;
+        sec->floorheight = R_Lerp(sec->oldfloorheight, sec->floorheight);
+        sec->ceilingheight = R_Lerp(sec->oldceilingheight, sec->ceilingheight);
+    }
+}
+
+static void R_RestoreSectors(void) {
+    sector_t *sec;
+    int i;
+
+    for (i = 0, sec = sectors; i < numsectors; i++, sec++) {
+        sec->floorheight = sectorheights[2 * i];
+        sec->ceilingheight = sectorheights[2 * i + 1];
+    }
+}
+
+//
+// R_SetupStrip
+// Limits drawing on the calling thread to the columns x1 to x2,
+//  and resets the state it keeps separately from other threads.
+//
+static void R_SetupStrip(int x1, int x2) {
+    stripx1 = x1;
+    stripx2 = x2;
+
+    Z_ResetArena(&framearena);
+
+    colfunc = basecolfunc;
+    spanfunc = basespanfunc;
+
+    // Walls and flats are recorded, then drawn by R_FlushDrawQueue.
+    if (drawqueue) {
+        colfunc = R_QueueColumn;
+        spanfunc = R_QueueSpan;
+    }
+
+    if (fixedcolormap)
+        walllights = scalelightfixed;
+}
+
+//
+// R_RenderStrip
+// Renders one strip of the view on a worker thread.
+// Every strip walks the whole BSP and makes the same clipping
+//  decisions as a full view, only the drawing is limited to it.
+//
+static int stripfuzzpos;
+
+static void R_RenderStrip(int strip, int numstrips) {
+    R_SetupStrip(viewwidth * strip / numstrips, viewwidth * (strip + 1) / numstrips - 1);
+
+    // Fuzz columns outside the strip still advance fuzzpos,
+    //  so all strips end the frame at the same position.
+    fuzzpos = stripfuzzpos;
+
+    R_ClearClipSegs();
+    R_ClearDrawSegs();
+    R_ClearPlanes();
+    R_ClearSprites();
+
+    R_RenderBSPNode(numnodes - 1);
+    R_DrawPlanes();
+    R_FlushDrawQueue();
+    R_DrawMasked();
+    R_TransposeView(stripx1 << detailshift, ((stripx2 + 1) << detailshift) - 1);
+
+    R_UpdateFrameStats();
+}
+
 //
 // R_RenderView
 //
-void R_RenderPlayerView(player_t *player) {
+static void R_RenderView(player_t *player) {
     R_SetupFrame(player);
 
+    if (I_NumWorkers() > 1) {
+        // check for new console commands.
+        NetUpdate();
+
+        stripfuzzpos = fuzzpos;
+        I_RunWorkers(R_RenderStrip);
+
+        // Check for new console commands.
+        NetUpdate();
+        return;
+    }
+
+    R_SetupStrip(0, viewwidth - 1);
+
     // Clear buffers.
     R_ClearClipSegs();
     R_ClearDrawSegs();
@@ -711,12 +1104,31 @@ void R_RenderPlayerView(player_t *player) {
     NetUpdate();
 
     R_DrawPlanes();
+    R_FlushDrawQueue();
 
     // Check for new console commands.
     NetUpdate();
 
     R_DrawMasked();
+    R_TransposeView(0, scaledviewwidth - 1);
+
+    R_UpdateFrameStats();
 
     // Check for new console commands.
     NetUpdate();
 }
+
+//
+// R_RenderPlayerView
+// Draws the view, with the sector planes moved
+//  part of the way through the last tic if interpolating.
+//
+void R_RenderPlayerView(player_t *player) {
+    if (fractionaltic < FRACUNIT)
+        R_InterpolateSectors();
+
+    R_RenderView(player);
+
+    if (fractionaltic < FRACUNIT)
+        R_RestoreSectors();
+}
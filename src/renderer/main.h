@@ -19,6 +19,7 @@
 #ifndef __R_MAIN__
 #define __R_MAIN__
 
+#include "../mem/arena.h"
 #include "../player/player.h"
 #include "data.h"
 
@@ -40,6 +41,8 @@ extern fixed_t projection;
 
 extern int validcount;
 
+extern THREADLOCAL arena_t framearena;
+
 extern int linecount;
 extern int loopcount;
 
@@ -66,6 +69,9 @@ extern lighttable_t *zlight[LIGHTLEVELS][MAXLIGHTZ];
 extern int extralight;
 extern lighttable_t *fixedcolormap;
 
+// Fraction of the last tic to interpolate by, FRACUNIT for none.
+extern fixed_t fractionaltic;
+
 // Number of diminishing brightness levels.
 // There a 0-31, i.e. 32 LUT in the COLORMAP lump.
 #define NUMCOLORMAPS 32
@@ -79,12 +85,13 @@ extern int detailshift;
 // Function pointers to switch refresh/drawing functions.
 // Used to select shadow mode etc.
 //
-extern void (*colfunc)(void);
+extern THREADLOCAL void (*colfunc)(void);
 extern void (*transcolfunc)(void);
 extern void (*basecolfunc)(void);
 extern void (*fuzzcolfunc)(void);
 // No shadow effects on floors.
-extern void (*spanfunc)(void);
+extern void (*basespanfunc)(void);
+extern THREADLOCAL void (*spanfunc)(void);
 
 //
 // Utility functions.
@@ -101,6 +108,10 @@ fixed_t R_PointToDist(fixed_t x, fixed_t y);
 fixed_t R_ScaleFromGlobalAngle(angle_t visangle);
 
 subsector_t *R_PointInSubsector(fixed_t x, fixed_t y);
+void R_InitPointGrid(void);
+
+fixed_t R_Lerp(fixed_t from, fixed_t to);
+angle_t R_LerpAngle(angle_t from, angle_t to);
 
 //
 // REFRESH - the actual rendering functions.
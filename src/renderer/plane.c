@@ -39,47 +39,52 @@ planefunction_t ceilingfunc;
 //
 
 // Here comes the obnoxious "visplane".
-#define MAXVISPLANES 128
-visplane_t visplanes[MAXVISPLANES];
-visplane_t *lastvisplane;
-visplane_t *floorplane;
-visplane_t *ceilingplane;
-
-// ?
-#define MAXOPENINGS SCREENWIDTH * 64
-short openings[MAXOPENINGS];
-short *lastopening;
+// Visplanes come from the frame arena, listed in the order
+//  they were made, and are found by R_FindPlane through a hash
+//  on height, picnum and light level.
+#define VISPLANEHASH 128
+
+THREADLOCAL visplane_t **visplanes;
+THREADLOCAL int numvisplanes;
+static THREADLOCAL int maxvisplanes;
+static THREADLOCAL visplane_t *visplanehash[VISPLANEHASH];
+THREADLOCAL visplane_t *floorplane;
+THREADLOCAL visplane_t *ceilingplane;
+
+// Clip arrays kept by drawsegs for sprites and masked textures,
+//  taken from the frame arena.
+THREADLOCAL int numopenings;
 
 //
 // Clip values are the solid pixel bounding the range.
 //  floorclip starts out SCREENHEIGHT
 //  ceilingclip starts out -1
 //
-short floorclip[SCREENWIDTH];
-short ceilingclip[SCREENWIDTH];
+THREADLOCAL short floorclip[SCREENWIDTH];
+THREADLOCAL short ceilingclip[SCREENWIDTH];
 
 //
 // spanstart holds the start of a plane span
 // initialized to 0 at start
 //
-int spanstart[SCREENHEIGHT];
-int spanstop[SCREENHEIGHT];
+THREADLOCAL int spanstart[SCREENHEIGHT];
+THREADLOCAL int spanstop[SCREENHEIGHT];
 
 //
 // texture mapping
 //
-lighttable_t **planezlight;
-fixed_t planeheight;
+THREADLOCAL lighttable_t **planezlight;
+THREADLOCAL fixed_t planeheight;
 
 fixed_t yslope[SCREENHEIGHT];
 fixed_t distscale[SCREENWIDTH];
-fixed_t basexscale;
-fixed_t baseyscale;
+THREADLOCAL fixed_t basexscale;
+THREADLOCAL fixed_t baseyscale;
 
-fixed_t cachedheight[SCREENHEIGHT];
-fixed_t cacheddistance[SCREENHEIGHT];
-fixed_t cachedxstep[SCREENHEIGHT];
-fixed_t cachedystep[SCREENHEIGHT];
+THREADLOCAL fixed_t cachedheight[SCREENHEIGHT];
+THREADLOCAL fixed_t cacheddistance[SCREENHEIGHT];
+THREADLOCAL fixed_t cachedxstep[SCREENHEIGHT];
+THREADLOCAL fixed_t cachedystep[SCREENHEIGHT];
 
 //
 // R_InitPlanes
@@ -114,6 +119,10 @@ void R_MapPlane(int y, int x1, int x2) {
     }
 #endif
 
+    // Span lies entirely outside of this thread's strip.
+    if (x2 < stripx1 || x1 > stripx2)
+        return;
+
     if (planeheight != cachedheight[y]) {
         cachedheight[y] = planeheight;
         distance = cacheddistance[y] = FixedMul(planeheight, yslope[y]);
@@ -163,8 +172,12 @@ void R_ClearPlanes(void) {
         ceilingclip[i] = -1;
     }
 
-    lastvisplane = visplanes;
-    lastopening = openings;
+    maxvisplanes = 128;
+    visplanes = Z_ArenaAlloc(&framearena, maxvisplanes * sizeof(*visplanes));
+    numvisplanes = 0;
+    memset(visplanehash, 0, sizeof(visplanehash));
+
+    numopenings = 0;
 
     // texture calculation
     memset(cachedheight, 0, sizeof(cachedheight));
@@ -177,38 +190,81 @@ void R_ClearPlanes(void) {
     baseyscale = -FixedDiv(finesine[angle], centerxfrac);
 }
 
+//
+// R_NewOpenings
+//
+short *R_NewOpenings(int count) {
+    numopenings += count;
+
+    return Z_ArenaAlloc(&framearena, count * sizeof(short));
+}
+
+//
+// R_NewPlane
+// The top and bottom of a new plane are left alone here;
+//  R_CheckPlane clears columns as they join the plane.
+//
+static visplane_t *R_NewPlane(fixed_t height, int picnum, int lightlevel) {
+    visplane_t *pl;
+
+    if (numvisplanes == maxvisplanes) {
+        visplanes = Z_ArenaGrow(&framearena, visplanes, maxvisplanes * sizeof(*visplanes),
+                                maxvisplanes * 2 * sizeof(*visplanes));
+        maxvisplanes *= 2;
+    }
+
+    pl = Z_ArenaAlloc(&framearena, sizeof(*pl));
+    pl->height = height;
+    pl->picnum = picnum;
+    pl->lightlevel = lightlevel;
+    pl->minx = SCREENWIDTH;
+    pl->maxx = -1;
+    pl->next = NULL;
+
+    visplanes[numvisplanes++] = pl;
+
+    return pl;
+}
+
+//
+// R_ClearPlaneColumns
+// Marks columns x1 to x2 of a plane as empty.  An empty column
+//  has top 0xff and a bottom that is anything but 0xff.
+//
+static void R_ClearPlaneColumns(visplane_t *pl, int x1, int x2) {
+    if (x1 > x2)
+        return;
+
+    memset(pl->top + x1, 0xff, x2 - x1 + 1);
+    memset(pl->bottom + x1, 0, x2 - x1 + 1);
+}
+
 //
 // R_FindPlane
 //
 visplane_t *R_FindPlane(fixed_t height, int picnum, int lightlevel) {
     visplane_t *check;
+    unsigned hash;
 
     if (picnum == skyflatnum) {
         height = 0; // all skys map together
         lightlevel = 0;
     }
 
-    for (check = visplanes; check < lastvisplane; check++) {
+    // Only the first plane made for each key is in the hash, the
+    //  one a scan through all visplanes would have found.
+    hash = ((unsigned)height >> FRACBITS) * 7 + picnum * 3 + lightlevel;
+    hash &= VISPLANEHASH - 1;
+
+    for (check = visplanehash[hash]; check != NULL; check = check->next) {
         if (height == check->height && picnum == check->picnum && lightlevel == check->lightlevel) {
-            break;
+            return check;
         }
     }
 
-    if (check < lastvisplane)
-        return check;
-
-    if (lastvisplane - visplanes == MAXVISPLANES)
-        error("R_FindPlane: no more visplanes");
-
-    lastvisplane++;
-
-    check->height = height;
-    check->picnum = picnum;
-    check->lightlevel = lightlevel;
-    check->minx = SCREENWIDTH;
-    check->maxx = -1;
-
-    memset(check->top, 0xff, sizeof(check->top));
+    check = R_NewPlane(height, picnum, lightlevel);
+    check->next = visplanehash[hash];
+    visplanehash[hash] = check;
 
     return check;
 }
@@ -244,6 +300,13 @@ visplane_t *R_CheckPlane(visplane_t *pl, int start, int stop) {
             break;
 
     if (x > intrh) {
+        if (pl->minx > pl->maxx) {
+            R_ClearPlaneColumns(pl, start, stop);
+        } else {
+            R_ClearPlaneColumns(pl, unionl, pl->minx - 1);
+            R_ClearPlaneColumns(pl, pl->maxx + 1, unionh);
+        }
+
         pl->minx = unionl;
         pl->maxx = unionh;
 
@@ -252,18 +315,11 @@ visplane_t *R_CheckPlane(visplane_t *pl, int start, int stop) {
     }
 
     // make a new visplane
-    lastvisplane->height = pl->height;
-    lastvisplane->picnum = pl->picnum;
-    lastvisplane->lightlevel = pl->lightlevel;
-
-    if (lastvisplane - visplanes == MAXVISPLANES)
-        error("R_CheckPlane: no more visplanes");
-
-    pl = lastvisplane++;
+    pl = R_NewPlane(pl->height, pl->picnum, pl->lightlevel);
     pl->minx = start;
     pl->maxx = stop;
 
-    memset(pl->top, 0xff, sizeof(pl->top));
+    R_ClearPlaneColumns(pl, start, stop);
 
     return pl;
 }
@@ -297,27 +353,22 @@ void R_MakeSpans(int x, int t1, int b1, int t2, int b2) {
 //
 void R_DrawPlanes(void) {
     visplane_t *pl;
+    int i;
     int light;
     int x;
     int stop;
     int angle;
     int lumpnum;
 
-#ifdef RANGECHECK
-    if (ds_p - drawsegs > MAXDRAWSEGS)
-        error("R_DrawPlanes: drawsegs overflow (%" PRIiPTR ")", ds_p - drawsegs);
-
-    if (lastvisplane - visplanes > MAXVISPLANES)
-        error("R_DrawPlanes: visplane overflow (%" PRIiPTR ")", lastvisplane - visplanes);
-
-    if (lastopening - openings > MAXOPENINGS)
-        error("R_DrawPlanes: opening overflow (%" PRIiPTR ")", lastopening - openings);
-#endif
+    for (i = 0; i < numvisplanes; i++) {
+        pl = visplanes[i];
 
-    for (pl = visplanes; pl < lastvisplane; pl++) {
         if (pl->minx > pl->maxx)
             continue;
 
+        if (pl->maxx < stripx1 || pl->minx > stripx2)
+            continue;
+
         // sky flat
         if (pl->picnum == skyflatnum) {
             dc_iscale = pspriteiscale >> detailshift;
@@ -359,6 +410,8 @@ void R_DrawPlanes(void) {
 
         pl->top[pl->maxx + 1] = 0xff;
         pl->top[pl->minx - 1] = 0xff;
+        pl->bottom[pl->minx - 1] = 0;
+        pl->bottom[pl->maxx + 1] = 0;
 
         stop = pl->maxx + 1;
 
@@ -22,15 +22,15 @@
 #include "data.h"
 
 // Visplane related.
-extern short *lastopening;
+extern THREADLOCAL int numopenings;
 
 typedef void (*planefunction_t)(int top, int bottom);
 
 extern planefunction_t floorfunc;
 extern planefunction_t ceilingfunc_t;
 
-extern short floorclip[SCREENWIDTH];
-extern short ceilingclip[SCREENWIDTH];
+extern THREADLOCAL short floorclip[SCREENWIDTH];
+extern THREADLOCAL short ceilingclip[SCREENWIDTH];
 
 extern fixed_t yslope[SCREENHEIGHT];
 extern fixed_t distscale[SCREENWIDTH];
@@ -38,6 +38,8 @@ extern fixed_t distscale[SCREENWIDTH];
 void R_InitPlanes(void);
 void R_ClearPlanes(void);
 
+short *R_NewOpenings(int count);
+
 void R_MapPlane(int y, int x1, int x2);
 
 void R_MakeSpans(int x, int t1, int b1, int t2, int b2);
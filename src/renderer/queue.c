@@ -0,0 +1,254 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Deferred drawing of wall columns and flat spans.
+//	While the BSP and the visplanes are walked, the column and
+//	 span drawers only record what they would draw.  The commands
+//	 are then sorted by source texture and colormap and drawn in
+//	 one pass, so each texture is read while it is still cached.
+//	Walls and flats never overlap on screen, so the order they
+//	 are drawn in does not change the frame.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../impl/system.h"
+#include "../lib/argv.h"
+#include "../wad/wad.h"
+
+#include "local.h"
+#include "queue.h"
+
+typedef struct {
+    byte *source;
+    lighttable_t *colormap;
+    fixed_t texturemid;
+    fixed_t iscale;
+    short x;
+    short yl;
+    short yh;
+    int order;
+} colcmd_t;
+
+typedef struct {
+    byte *source;
+    lighttable_t *colormap;
+    fixed_t xfrac;
+    fixed_t yfrac;
+    fixed_t xstep;
+    fixed_t ystep;
+    short y;
+    short x1;
+    short x2;
+    int order;
+} spancmd_t;
+
+boolean drawqueue;
+
+static THREADLOCAL colcmd_t *colcmds;
+static THREADLOCAL int numcolcmds;
+static THREADLOCAL int maxcolcmds;
+
+static THREADLOCAL spancmd_t *spancmds;
+static THREADLOCAL int numspancmds;
+static THREADLOCAL int maxspancmds;
+
+// Draw work over all frames, reported at exit.
+static int queueframes;
+static int64_t queuecolumns;
+static int64_t queuespans;
+static int64_t queuepixels;
+
+//
+// R_QueueColumn
+// Records the column set up in the dc_ variables.
+//
+void R_QueueColumn(void) {
+    colcmd_t *cmd;
+
+    if (dc_yh < dc_yl || dc_x < stripx1 || dc_x > stripx2)
+        return;
+
+    if (numcolcmds == maxcolcmds) {
+        maxcolcmds = maxcolcmds ? maxcolcmds * 2 : 1024;
+        colcmds = I_Realloc(colcmds, maxcolcmds * sizeof(*colcmds));
+    }
+
+    cmd = &colcmds[numcolcmds];
+    cmd->source = dc_source;
+    cmd->colormap = dc_colormap;
+    cmd->texturemid = dc_texturemid;
+    cmd->iscale = dc_iscale;
+    cmd->x = dc_x;
+    cmd->yl = dc_yl;
+    cmd->yh = dc_yh;
+    cmd->order = numcolcmds++;
+}
+
+//
+// R_QueueSpan
+// Records the span set up in the ds_ variables.
+//
+void R_QueueSpan(void) {
+    spancmd_t *cmd;
+
+    if (numspancmds == maxspancmds) {
+        maxspancmds = maxspancmds ? maxspancmds * 2 : 1024;
+        spancmds = I_Realloc(spancmds, maxspancmds * sizeof(*spancmds));
+    }
+
+    cmd = &spancmds[numspancmds];
+    cmd->source = ds_source;
+    cmd->colormap = ds_colormap;
+    cmd->xfrac = ds_xfrac;
+    cmd->yfrac = ds_yfrac;
+    cmd->xstep = ds_xstep;
+    cmd->ystep = ds_ystep;
+    cmd->y = ds_y;
+    cmd->x1 = ds_x1;
+    cmd->x2 = ds_x2;
+    cmd->order = numspancmds++;
+}
+
+static int CompareColumns(const void *a, const void *b) {
+    const colcmd_t *c1 = a;
+    const colcmd_t *c2 = b;
+
+    if (c1->source != c2->source)
+        return c1->source < c2->source ? -1 : 1;
+
+    if (c1->colormap != c2->colormap)
+        return c1->colormap < c2->colormap ? -1 : 1;
+
+    return c1->order - c2->order;
+}
+
+static int CompareSpans(const void *a, const void *b) {
+    const spancmd_t *s1 = a;
+    const spancmd_t *s2 = b;
+
+    if (s1->source != s2->source)
+        return s1->source < s2->source ? -1 : 1;
+
+    if (s1->colormap != s2->colormap)
+        return s1->colormap < s2->colormap ? -1 : 1;
+
+    return s1->order - s2->order;
+}
+
+//
+// R_FlushDrawQueue
+// Called between R_DrawPlanes and R_DrawMasked.
+//
+void R_FlushDrawQueue(void) {
+    colcmd_t *col;
+    spancmd_t *span;
+    int pixels;
+    int x1;
+    int x2;
+
+    if (!drawqueue)
+        return;
+
+    qsort(colcmds, numcolcmds, sizeof(*colcmds), CompareColumns);
+    qsort(spancmds, numspancmds, sizeof(*spancmds), CompareSpans);
+
+    pixels = 0;
+
+    for (col = colcmds; col < colcmds + numcolcmds; col++) {
+        dc_source = col->source;
+        dc_colormap = col->colormap;
+        dc_texturemid = col->texturemid;
+        dc_iscale = col->iscale;
+        dc_x = col->x;
+        dc_yl = col->yl;
+        dc_yh = col->yh;
+        basecolfunc();
+
+        pixels += col->yh - col->yl + 1;
+    }
+
+    for (span = spancmds; span < spancmds + numspancmds; span++) {
+        ds_source = span->source;
+        ds_colormap = span->colormap;
+        ds_xfrac = span->xfrac;
+        ds_yfrac = span->yfrac;
+        ds_xstep = span->xstep;
+        ds_ystep = span->ystep;
+        ds_y = span->y;
+        ds_x1 = span->x1;
+        ds_x2 = span->x2;
+        basespanfunc();
+
+        x1 = span->x1 < stripx1 ? stripx1 : span->x1;
+        x2 = span->x2 > stripx2 ? stripx2 : span->x2;
+        pixels += x2 - x1 + 1;
+    }
+
+    __atomic_add_fetch(&queuecolumns, numcolcmds, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&queuespans, numspancmds, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&queuepixels, pixels, __ATOMIC_RELAXED);
+
+    if (!stripx1)
+        queueframes++;
+
+    numcolcmds = 0;
+    numspancmds = 0;
+
+    colfunc = basecolfunc;
+    spanfunc = basespanfunc;
+}
+
+static void R_PrintDrawQueueStats(void) {
+    if (!queueframes)
+        return;
+
+    printf("R_DrawQueue: %i frames, per frame %" PRId64 " columns, %" PRId64 " spans, %" PRId64 " pixels\n",
+           queueframes, queuecolumns / queueframes, queuespans / queueframes, queuepixels / queueframes);
+}
+
+//
+// R_InitDrawQueue
+// The queue keeps source pointers until the end of the frame,
+//  so nothing it records may be purged from the zone before then:
+//  lumps have to be mapped and composites are made resident.
+//
+void R_InitDrawQueue(void) {
+    int i;
+
+    //!
+    // @category video
+    //
+    // Record wall and flat drawing and play it back sorted by texture,
+    // printing the amount of draw work per frame at exit.
+    //
+
+    drawqueue = M_ParmExists("-drawqueue");
+
+    if (!drawqueue)
+        return;
+
+    for (i = 0; i < numlumps; i++) {
+        if (lumpinfo[i]->wad_file->mapped == NULL) {
+            printf("R_InitDrawQueue: WAD files are not memory mapped, drawing directly.\n");
+            drawqueue = false;
+            return;
+        }
+    }
+
+    R_InitComposites();
+    I_AtExit(R_PrintDrawQueueStats, false);
+}
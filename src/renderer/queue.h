@@ -0,0 +1,33 @@
+//
+// Copyright(C) 1993-1996 Id Software, Inc.
+// Copyright(C) 2005-2014 Simon Howard
+//
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either version 2
+// of the License, or (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// DESCRIPTION:
+//	Deferred drawing of wall columns and flat spans.
+//
+
+#ifndef __R_QUEUE__
+#define __R_QUEUE__
+
+extern boolean drawqueue;
+
+void R_InitDrawQueue(void);
+
+// Stand-ins for colfunc and spanfunc while walls and flats are recorded.
+void R_QueueColumn(void);
+void R_QueueSpan(void);
+
+// Sort the recorded commands and draw them.
+void R_FlushDrawQueue(void);
+
+#endif
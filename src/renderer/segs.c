@@ -30,54 +30,54 @@
 // OPTIMIZE: closed two sided lines as single sided
 
 // True if any of the segs textures might be visible.
-boolean segtextured;
+THREADLOCAL boolean segtextured;
 
 // False if the back side is the same plane.
-boolean markfloor;
-boolean markceiling;
+THREADLOCAL boolean markfloor;
+THREADLOCAL boolean markceiling;
 
-boolean maskedtexture;
-int toptexture;
-int bottomtexture;
-int midtexture;
+THREADLOCAL boolean maskedtexture;
+THREADLOCAL int toptexture;
+THREADLOCAL int bottomtexture;
+THREADLOCAL int midtexture;
 
-angle_t rw_normalangle;
+THREADLOCAL angle_t rw_normalangle;
 // angle to line origin
-int rw_angle1;
+THREADLOCAL int rw_angle1;
 
 //
 // regular wall
 //
-int rw_x;
-int rw_stopx;
-angle_t rw_centerangle;
-fixed_t rw_offset;
-fixed_t rw_distance;
-fixed_t rw_scale;
-fixed_t rw_scalestep;
-fixed_t rw_midtexturemid;
-fixed_t rw_toptexturemid;
-fixed_t rw_bottomtexturemid;
+THREADLOCAL int rw_x;
+THREADLOCAL int rw_stopx;
+THREADLOCAL angle_t rw_centerangle;
+THREADLOCAL fixed_t rw_offset;
+THREADLOCAL fixed_t rw_distance;
+THREADLOCAL fixed_t rw_scale;
+THREADLOCAL fixed_t rw_scalestep;
+THREADLOCAL fixed_t rw_midtexturemid;
+THREADLOCAL fixed_t rw_toptexturemid;
+THREADLOCAL fixed_t rw_bottomtexturemid;
 
-int worldtop;
-int worldbottom;
-int worldhigh;
-int worldlow;
+THREADLOCAL int worldtop;
+THREADLOCAL int worldbottom;
+THREADLOCAL int worldhigh;
+THREADLOCAL int worldlow;
 
-fixed_t pixhigh;
-fixed_t pixlow;
-fixed_t pixhighstep;
-fixed_t pixlowstep;
+THREADLOCAL fixed_t pixhigh;
+THREADLOCAL fixed_t pixlow;
+THREADLOCAL fixed_t pixhighstep;
+THREADLOCAL fixed_t pixlowstep;
 
-fixed_t topfrac;
-fixed_t topstep;
+THREADLOCAL fixed_t topfrac;
+THREADLOCAL fixed_t topstep;
 
-fixed_t bottomfrac;
-fixed_t bottomstep;
+THREADLOCAL fixed_t bottomfrac;
+THREADLOCAL fixed_t bottomstep;
 
-lighttable_t **walllights;
+THREADLOCAL lighttable_t **walllights;
 
-short *maskedtexturecol;
+THREADLOCAL short *maskedtexturecol;
 
 //
 // R_RenderMaskedSegRange
@@ -322,9 +322,13 @@ void R_StoreWallRange(int start, int stop) {
     fixed_t vtop;
     int lightnum;
 
-    // don't overflow and crash
-    if (ds_p == &drawsegs[MAXDRAWSEGS])
-        return;
+    // out of drawsegs, move them to a bigger block
+    if (ds_p == drawsegs + maxdrawsegs) {
+        drawsegs = Z_ArenaGrow(&framearena, drawsegs, maxdrawsegs * sizeof(*drawsegs),
+                               maxdrawsegs * 2 * sizeof(*drawsegs));
+        ds_p = drawsegs + maxdrawsegs;
+        maxdrawsegs *= 2;
+    }
 
 #ifdef RANGECHECK
     if (start >= viewwidth || start > stop)
@@ -335,7 +339,9 @@ void R_StoreWallRange(int start, int stop) {
     linedef = curline->linedef;
 
     // mark the segment as visible for auto map
-    linedef->flags |= ML_MAPPED;
+    //  (left to the first strip, all of them see the same segs)
+    if (!stripx1)
+        linedef->flags |= ML_MAPPED;
 
     // calculate rw_distance for scale calculation
     rw_normalangle = curline->angle + ANG90;
@@ -503,8 +509,7 @@ void R_StoreWallRange(int start, int stop) {
         if (sidedef->midtexture) {
             // masked midtexture
             maskedtexture = true;
-            ds_p->maskedtexturecol = maskedtexturecol = lastopening - rw_x;
-            lastopening += rw_stopx - rw_x;
+            ds_p->maskedtexturecol = maskedtexturecol = R_NewOpenings(rw_stopx - rw_x) - rw_x;
         }
     }
 
@@ -600,15 +605,13 @@ void R_StoreWallRange(int start, int stop) {
 
     // save sprite clipping info
     if (((ds_p->silhouette & SIL_TOP) || maskedtexture) && !ds_p->sprtopclip) {
-        memcpy(lastopening, ceilingclip + start, sizeof(*lastopening) * (rw_stopx - start));
-        ds_p->sprtopclip = lastopening - start;
-        lastopening += rw_stopx - start;
+        ds_p->sprtopclip = R_NewOpenings(rw_stopx - start) - start;
+        memcpy(ds_p->sprtopclip + start, ceilingclip + start, sizeof(*ceilingclip) * (rw_stopx - start));
     }
 
     if (((ds_p->silhouette & SIL_BOTTOM) || maskedtexture) && !ds_p->sprbottomclip) {
-        memcpy(lastopening, floorclip + start, sizeof(*lastopening) * (rw_stopx - start));
-        ds_p->sprbottomclip = lastopening - start;
-        lastopening += rw_stopx - start;
+        ds_p->sprbottomclip = R_NewOpenings(rw_stopx - start) - start;
+        memcpy(ds_p->sprbottomclip + start, floorclip + start, sizeof(*floorclip) * (rw_stopx - start));
     }
 
     if (maskedtexture && !(ds_p->silhouette & SIL_TOP)) {
@@ -57,7 +57,7 @@ typedef struct {
 fixed_t pspritescale;
 fixed_t pspriteiscale;
 
-lighttable_t **spritelights;
+THREADLOCAL lighttable_t **spritelights;
 
 // constant arrays
 //  used for psprite clipping and initializing clipping
@@ -244,8 +244,11 @@ void R_InitSpriteDefs(const char **namelist) {
 //
 // GAME FUNCTIONS
 //
-vissprite_t vissprites[MAXVISSPRITES];
-vissprite_t *vissprite_p;
+// Vissprites live in the frame arena and move to a bigger
+//  block when they run out.
+THREADLOCAL vissprite_t *vissprites;
+THREADLOCAL vissprite_t *vissprite_p;
+static THREADLOCAL int maxvissprites;
 int newvissprite;
 
 //
@@ -266,16 +269,33 @@ void R_InitSprites(const char **namelist) {
 // R_ClearSprites
 // Called at frame start.
 //
-void R_ClearSprites(void) { vissprite_p = vissprites; }
+// Per-thread record of the sectors whose sprites have been added
+//  this frame, so that strip threads do not share sector_t::validcount.
+static THREADLOCAL int *spritesectors;
+static THREADLOCAL int numspritesectors;
+
+void R_ClearSprites(void) {
+    maxvissprites = MAXVISSPRITES;
+    vissprites = Z_ArenaAlloc(&framearena, maxvissprites * sizeof(*vissprites));
+    vissprite_p = vissprites;
+
+    if (numspritesectors < numsectors) {
+        spritesectors = I_Realloc(spritesectors, numsectors * sizeof(*spritesectors));
+        memset(spritesectors + numspritesectors, 0, (numsectors - numspritesectors) * sizeof(*spritesectors));
+        numspritesectors = numsectors;
+    }
+}
 
 //
 // R_NewVisSprite
 //
-vissprite_t overflowsprite;
-
 vissprite_t *R_NewVisSprite(void) {
-    if (vissprite_p == &vissprites[MAXVISSPRITES])
-        return &overflowsprite;
+    if (vissprite_p == vissprites + maxvissprites) {
+        vissprites = Z_ArenaGrow(&framearena, vissprites, maxvissprites * sizeof(*vissprites),
+                                 maxvissprites * 2 * sizeof(*vissprites));
+        vissprite_p = vissprites + maxvissprites;
+        maxvissprites *= 2;
+    }
 
     vissprite_p++;
     return vissprite_p - 1;
@@ -287,11 +307,11 @@ vissprite_t *R_NewVisSprite(void) {
 // Masked means: partly transparent, i.e. stored
 //  in posts/runs of opaque pixels.
 //
-short *mfloorclip;
-short *mceilingclip;
+THREADLOCAL short *mfloorclip;
+THREADLOCAL short *mceilingclip;
 
-fixed_t spryscale;
-fixed_t sprtopscreen;
+THREADLOCAL fixed_t spryscale;
+THREADLOCAL fixed_t sprtopscreen;
 
 void R_DrawMaskedColumn(column_t *column) {
     int topscreen;
@@ -404,9 +424,28 @@ void R_ProjectSprite(mobj_t *thing) {
     angle_t ang;
     fixed_t iscale;
 
+    fixed_t thingx;
+    fixed_t thingy;
+    fixed_t thingz;
+    angle_t thingangle;
+
+    // Between tics, draw the thing part of the way
+    //  from where the last tic found it.
+    if (fractionaltic < FRACUNIT) {
+        thingx = R_Lerp(MO_OLDX(thing), thing->x);
+        thingy = R_Lerp(MO_OLDY(thing), thing->y);
+        thingz = R_Lerp(MO_OLDZ(thing), thing->z);
+        thingangle = R_LerpAngle(MO_OLDANGLE(thing), thing->angle);
+    } else {
+        thingx = thing->x;
+        thingy = thing->y;
+        thingz = thing->z;
+        thingangle = thing->angle;
+    }
+
     // transform the origin point
-    tr_x = thing->x - viewx;
-    tr_y = thing->y - viewy;
+    tr_x = thingx - viewx;
+    tr_y = thingy - viewy;
 
     gxt = FixedMul(tr_x, viewcos);
     gyt = -FixedMul(tr_y, viewsin);
@@ -441,8 +480,8 @@ void R_ProjectSprite(mobj_t *thing) {
 
     if (sprframe->rotate) {
         // choose a different rotation based on player view
-        ang = R_PointToAngle(thing->x, thing->y);
-        rot = (ang - thing->angle + (unsigned)(ANG45 / 2) * 9) >> 29;
+        ang = R_PointToAngle(thingx, thingy);
+        rot = (ang - thingangle + (unsigned)(ANG45 / 2) * 9) >> 29;
         lump = sprframe->lump[rot];
         flip = (boolean)sprframe->flip[rot];
     } else {
@@ -470,10 +509,10 @@ void R_ProjectSprite(mobj_t *thing) {
     vis = R_NewVisSprite();
     vis->mobjflags = thing->flags;
     vis->scale = xscale << detailshift;
-    vis->gx = thing->x;
-    vis->gy = thing->y;
-    vis->gz = thing->z;
-    vis->gzt = thing->z + spritetopoffset[lump];
+    vis->gx = thingx;
+    vis->gy = thingy;
+    vis->gz = thingz;
+    vis->gzt = thingz + spritetopoffset[lump];
     vis->texturemid = vis->gzt - viewz;
     vis->x1 = x1 < 0 ? 0 : x1;
     vis->x2 = x2 >= viewwidth ? viewwidth - 1 : x2;
@@ -526,11 +565,11 @@ void R_AddSprites(sector_t *sec) {
     // A sector might have been split into several
     //  subsectors during BSP building.
     // Thus we check whether its already added.
-    if (sec->validcount == validcount)
+    if (spritesectors[sec - sectors] == validcount)
         return;
 
     // Well, now it will be done.
-    sec->validcount = validcount;
+    spritesectors[sec - sectors] = validcount;
 
     lightnum = (sec->lightlevel >> LIGHTSEGSHIFT) + extralight;
 
@@ -661,52 +700,111 @@ void R_DrawPlayerSprites(void) {
 
 //
 // R_SortVisSprites
+// Stable merge sort on scale, so sprites at the same scale are
+//  drawn in the order they were projected.
 //
-vissprite_t vsprsortedhead;
+THREADLOCAL vissprite_t vsprsortedhead;
 
 void R_SortVisSprites(void) {
-    int i;
     int count;
-    vissprite_t *ds;
-    vissprite_t *best;
-    vissprite_t unsorted;
-    fixed_t bestscale;
+    int width;
+    int lo;
+    int mid;
+    int hi;
+    int i;
+    int j;
+    int k;
+    vissprite_t **sorted;
+    vissprite_t **merged;
+    vissprite_t **swap;
 
     count = vissprite_p - vissprites;
 
-    unsorted.next = unsorted.prev = &unsorted;
-
     if (!count)
         return;
 
-    for (ds = vissprites; ds < vissprite_p; ds++) {
-        ds->next = ds + 1;
-        ds->prev = ds - 1;
-    }
+    sorted = Z_ArenaAlloc(&framearena, count * sizeof(*sorted));
+    merged = Z_ArenaAlloc(&framearena, count * sizeof(*merged));
 
-    vissprites[0].prev = &unsorted;
-    unsorted.next = &vissprites[0];
-    (vissprite_p - 1)->next = &unsorted;
-    unsorted.prev = vissprite_p - 1;
+    for (i = 0; i < count; i++)
+        sorted[i] = &vissprites[i];
 
-    // pull the vissprites out by scale
+    for (width = 1; width < count; width *= 2) {
+        for (lo = 0; lo < count; lo += 2 * width) {
+            mid = lo + width < count ? lo + width : count;
+            hi = lo + 2 * width < count ? lo + 2 * width : count;
 
-    vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
-    for (i = 0; i < count; i++) {
-        bestscale = INT_MAX;
-        best = unsorted.next;
-        for (ds = unsorted.next; ds != &unsorted; ds = ds->next) {
-            if (ds->scale < bestscale) {
-                bestscale = ds->scale;
-                best = ds;
+            i = lo;
+            j = mid;
+            k = lo;
+
+            while (i < mid && j < hi) {
+                if (sorted[j]->scale < sorted[i]->scale)
+                    merged[k++] = sorted[j++];
+                else
+                    merged[k++] = sorted[i++];
             }
+
+            while (i < mid)
+                merged[k++] = sorted[i++];
+
+            while (j < hi)
+                merged[k++] = sorted[j++];
         }
-        best->next->prev = best->prev;
-        best->prev->next = best->next;
-        best->next = &vsprsortedhead;
-        best->prev = vsprsortedhead.prev;
-        vsprsortedhead.prev->next = best;
-        vsprsortedhead.prev = best;
+
+        swap = sorted;
+        sorted = merged;
+        merged = swap;
+    }
+
+    // link them up, furthest first
+    vsprsortedhead.next = vsprsortedhead.prev = &vsprsortedhead;
+
+    for (i = 0; i < count; i++) {
+        sorted[i]->next = &vsprsortedhead;
+        sorted[i]->prev = vsprsortedhead.prev;
+        vsprsortedhead.prev->next = sorted[i];
+        vsprsortedhead.prev = sorted[i];
+    }
+}
+
+//
+// R_IndexDrawSegs
+// Lists the drawsegs that can clip sprites in each bin of
+//  DRAWSEGBIN screen columns they overlap, latest first, so
+//  R_DrawSprite only looks at the segs near each sprite.
+//
+#define DRAWSEGBINSHIFT 5
+#define DRAWSEGBINS ((SCREENWIDTH >> DRAWSEGBINSHIFT) + 1)
+
+static THREADLOCAL int *drawsegbin[DRAWSEGBINS];
+static THREADLOCAL int drawsegbincount[DRAWSEGBINS];
+
+static void R_IndexDrawSegs(void) {
+    drawseg_t *ds;
+    int b;
+
+    memset(drawsegbincount, 0, sizeof(drawsegbincount));
+
+    for (ds = drawsegs; ds < ds_p; ds++) {
+        if (!ds->silhouette && !ds->maskedtexturecol)
+            continue;
+
+        for (b = ds->x1 >> DRAWSEGBINSHIFT; b <= ds->x2 >> DRAWSEGBINSHIFT; b++)
+            drawsegbincount[b]++;
+    }
+
+    for (b = 0; b < DRAWSEGBINS; b++) {
+        drawsegbin[b] = Z_ArenaAlloc(&framearena, drawsegbincount[b] * sizeof(int));
+        drawsegbincount[b] = 0;
+    }
+
+    for (ds = ds_p - 1; ds >= drawsegs; ds--) {
+        if (!ds->silhouette && !ds->maskedtexturecol)
+            continue;
+
+        for (b = ds->x1 >> DRAWSEGBINSHIFT; b <= ds->x2 >> DRAWSEGBINSHIFT; b++)
+            drawsegbin[b][drawsegbincount[b]++] = ds - drawsegs;
     }
 }
 
@@ -723,16 +821,45 @@ void R_DrawSprite(vissprite_t *spr) {
     fixed_t scale;
     fixed_t lowscale;
     int silhouette;
+    int binpos[DRAWSEGBINS];
+    int b1;
+    int b2;
+    int b;
+    int last;
 
     for (x = spr->x1; x <= spr->x2; x++)
         clipbot[x] = cliptop[x] = -2;
 
+    b1 = spr->x1 >> DRAWSEGBINSHIFT;
+    b2 = spr->x2 >> DRAWSEGBINSHIFT;
+
+    for (b = b1; b <= b2; b++)
+        binpos[b] = 0;
+
     // Scan drawsegs from end to start for obscuring segs.
     // The first drawseg that has a greater scale
     //  is the clip seg.
-    for (ds = ds_p - 1; ds >= drawsegs; ds--) {
+    for (;;) {
+        // Next drawseg over all the bins the sprite covers.
+        last = -1;
+
+        for (b = b1; b <= b2; b++) {
+            if (binpos[b] < drawsegbincount[b] && drawsegbin[b][binpos[b]] > last)
+                last = drawsegbin[b][binpos[b]];
+        }
+
+        if (last < 0)
+            break;
+
+        for (b = b1; b <= b2; b++) {
+            if (binpos[b] < drawsegbincount[b] && drawsegbin[b][binpos[b]] == last)
+                binpos[b]++;
+        }
+
+        ds = drawsegs + last;
+
         // determine if the drawseg obscures the sprite
-        if (ds->x1 > spr->x2 || ds->x2 < spr->x1 || (!ds->silhouette && !ds->maskedtexturecol)) {
+        if (ds->x1 > spr->x2 || ds->x2 < spr->x1) {
             // does not cover sprite
             continue;
         }
@@ -813,6 +940,8 @@ void R_DrawMasked(void) {
     R_SortVisSprites();
 
     if (vissprite_p > vissprites) {
+        R_IndexDrawSegs();
+
         // draw all vissprites back to front
         for (spr = vsprsortedhead.next; spr != &vsprsortedhead; spr = spr->next) {
 
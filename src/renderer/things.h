@@ -19,11 +19,12 @@
 #ifndef __R_THINGS__
 #define __R_THINGS__
 
+// Initial size of the per-frame vissprite array, which grows as needed.
 #define MAXVISSPRITES 128
 
-extern vissprite_t vissprites[MAXVISSPRITES];
-extern vissprite_t *vissprite_p;
-extern vissprite_t vsprsortedhead;
+extern THREADLOCAL vissprite_t *vissprites;
+extern THREADLOCAL vissprite_t *vissprite_p;
+extern THREADLOCAL vissprite_t vsprsortedhead;
 
 // Constant arrays used for psprite clipping
 //  and initializing clipping.
@@ -31,10 +32,10 @@ extern short negonearray[SCREENWIDTH];
 extern short screenheightarray[SCREENWIDTH];
 
 // vars for R_DrawMaskedColumn
-extern short *mfloorclip;
-extern short *mceilingclip;
-extern fixed_t spryscale;
-extern fixed_t sprtopscreen;
+extern THREADLOCAL short *mfloorclip;
+extern THREADLOCAL short *mceilingclip;
+extern THREADLOCAL fixed_t spryscale;
+extern THREADLOCAL fixed_t sprtopscreen;
 
 extern fixed_t pspritescale;
 extern fixed_t pspriteiscale;
@@ -391,6 +391,7 @@ cheatseq_t cheat_powerup[7] = {
 cheatseq_t cheat_choppers = CHEAT("idchoppers", 0);
 cheatseq_t cheat_clev = CHEAT("idclev", 2);
 cheatseq_t cheat_mypos = CHEAT("idmypos", 0);
+cheatseq_t cheat_zone = CHEAT("idzone", 0);
 
 //
 // STATUS BAR CODE
@@ -544,6 +545,13 @@ boolean ST_Responder(event_t *ev) {
                            players[consoleplayer].mo->x, players[consoleplayer].mo->y);
                 plyr->message = buf;
             }
+            // 'zone' for zone memory stats
+            else if (cht_CheckCheat(&cheat_zone, ev->data2)) {
+                static char buf[ST_MSGWIDTH];
+                Z_StatsSummary(buf, sizeof(buf));
+                Z_FileDumpHeap(stdout);
+                plyr->message = buf;
+            }
         }
 
         // 'clev' change-level cheat
@@ -18,7 +18,7 @@
 
 #include <stdio.h>
 
-#include "../misc/config.h"
+#include "../../config.h"
 
 #include "../lib/argv.h"
 #include "../lib/type.h"
@@ -16,19 +16,20 @@
 //	WAD I/O functions.
 //
 
-#include "../misc/config.h"
+#include "../../config.h"
 
 #ifdef HAVE_MMAP
 
 #include <errno.h>
 #include <fcntl.h>
+#include <stdio.h>
 #include <string.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
-#include "m_misc.h"
-#include "w_file.h"
-#include "zone.h"
+#include "../mem/zone.h"
+#include "../misc/misc.h"
+#include "file.h"
 
 typedef struct {
     wad_file_t wad;
@@ -63,7 +64,7 @@ static void MapFile(posix_wad_file_t *wad, const char *filename) {
     }
 }
 
-unsigned int GetFileLength(int handle) { return lseek(handle, 0, SEEK_END); }
+static unsigned int GetFileLength(int handle) { return lseek(handle, 0, SEEK_END); }
 
 static wad_file_t *W_POSIX_OpenFile(const char *path) {
     posix_wad_file_t *result;
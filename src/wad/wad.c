@@ -339,14 +339,17 @@ void *W_CacheLumpNum(lumpindex_t lumpnum, int tag) {
 
         result = lump->wad_file->mapped + lump->position;
     } else if (lump->cache != NULL) {
-        // Already cached, so just switch the zone tag.
+        // Already cached, so just switch the zone tag.  This also
+        // marks it as just used, so the cache keeps it longest.
 
         result = lump->cache;
         Z_ChangeTag(lump->cache, tag);
     } else {
-        // Not yet loaded, so load it now
+        // Not yet loaded, so load it now.  Zone stats count lumps
+        // under the WAD they come from.
 
-        lump->cache = Z_Malloc(W_LumpLength(lumpnum), tag, &lump->cache);
+        lump->cache =
+            Z_Malloc2(W_LumpLength(lumpnum), tag, &lump->cache, M_BaseName(lump->wad_file->path), 0);
         W_ReadLump(lumpnum, lump->cache);
         result = lump->cache;
     }